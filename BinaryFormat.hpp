@@ -0,0 +1,86 @@
+#ifndef __BINARYFORMAT__
+#define __BINARYFORMAT__
+
+#include <vector>
+#include <cstring>
+
+/*
+Binary update log (all integers little-endian).
+Header (BINARY_HEADER_SIZE bytes): magic, version, number of updates, number of nodes, maximum degree and maximum cardinality.
+Each update follows as varints:
+	(cardinality << 1) | (1 if deletion else 0),
+	the smallest endpoint, then the gap to each following endpoint (endpoints are sorted),
+	and for an insertion the zigzag-encoded difference between its timestamp and that of the previous insertion.
+*/
+
+const char BINARY_MAGIC[4] = {'\x89', 'H', 'G', 'U'};
+const unsigned BINARY_VERSION = 1;
+const size_t BINARY_HEADER_SIZE = 32;
+
+struct BinaryHeader {
+	unsigned version;
+	unsigned long long numberOfUpdates;
+	unsigned numberOfNodes, maxDegree, maxCardinality;
+};
+
+inline void putFixed(char *p, unsigned long long x, int bytes) {
+	for (int i = 0; i < bytes; ++i, x >>= 8)
+		p[i] = (char)(x & 0xff);
+}
+
+inline unsigned long long getFixed(const char *p, int bytes) {
+	unsigned long long x = 0;
+	for (int i = bytes - 1; i >= 0; --i)
+		x = (x << 8) | (unsigned char)p[i];
+	return x;
+}
+
+inline void encodeHeader(const BinaryHeader& header, char p[BINARY_HEADER_SIZE]) {
+	memset(p, 0, BINARY_HEADER_SIZE);
+	memcpy(p, BINARY_MAGIC, 4);
+	putFixed(p + 4, header.version, 4);
+	putFixed(p + 8, header.numberOfUpdates, 8);
+	putFixed(p + 16, header.numberOfNodes, 4);
+	putFixed(p + 20, header.maxDegree, 4);
+	putFixed(p + 24, header.maxCardinality, 4);
+}
+
+// Returns false if [p, p + len) does not start with a binary header
+inline bool decodeHeader(const char *p, size_t len, BinaryHeader& header) {
+	if (p == NULL || len < BINARY_HEADER_SIZE || memcmp(p, BINARY_MAGIC, 4) != 0)
+		return false;
+	header.version = getFixed(p + 4, 4);
+	header.numberOfUpdates = getFixed(p + 8, 8);
+	header.numberOfNodes = getFixed(p + 16, 4);
+	header.maxDegree = getFixed(p + 20, 4);
+	header.maxCardinality = getFixed(p + 24, 4);
+	return true;
+}
+
+inline void putVarint(std::vector<char>& out, unsigned x) {
+	while (x >= 0x80) {
+		out.push_back((char)(x | 0x80));
+		x >>= 7;
+	}
+	out.push_back((char)x);
+}
+
+// Returns NULL if the varint at p runs past end or is too long for an unsigned
+inline const char *getVarint(const char *p, const char *end, unsigned& x) {
+	x = 0;
+	for (int shift = 0; p < end && shift < 35; shift += 7) {
+		unsigned char byte = *p++;
+		x |= (unsigned)(byte & 0x7f) << shift;
+		if (byte < 0x80) return p;
+	}
+	return NULL;
+}
+
+inline unsigned zigzag(int x) {
+	return ((unsigned)x << 1) ^ (unsigned)(x >> 31);
+}
+
+inline int unzigzag(unsigned x) {
+	return (int)(x >> 1) ^ -(int)(x & 1);
+}
+#endif
@@ -0,0 +1,142 @@
+#ifndef __CHECKPOINT__
+#define __CHECKPOINT__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstring>
+#include "MappedFile.hpp"
+
+/*
+Checkpoint of an algorithm (see FullyDynamic::saveCheckpoint()).
+Header (CHECKPOINT_HEADER_SIZE bytes): magic, version, the name of the algorithm, its parameters,
+the byte offset in the log right after the last update applied, the number of updates up to there, the timestamp of the last insertion,
+a hash of the log up to the offset (see GraphScheduler::prefixHash()), so that a checkpoint is not restored on another log,
+and the scheduler flags that decide the IDs (see GraphScheduler::idFlags()).
+The state follows as values and arrays; an array is its number of elements (8 bytes) followed by the elements.
+Everything is stored as it is laid out in memory, so restoring is copying from the mapped file,
+and a checkpoint can only be restored on the kind of machine that wrote it.
+*/
+
+const char CHECKPOINT_MAGIC[4] = {'\x89', 'H', 'G', 'C'};
+const unsigned CHECKPOINT_VERSION = 3;
+const size_t CHECKPOINT_HEADER_SIZE = 80;
+
+struct CheckpointHeader {
+	char algorithm[16];
+	double parameters[3];
+	unsigned long long offset, updates, logHash;
+	int lastTimestamp;
+	unsigned schedulerFlags;
+};
+
+class CheckpointWriter {
+public:
+	// The checkpoint is written to fileName + ".tmp" and only replaces fileName in close(), so a crash leaves the previous one intact
+	CheckpointWriter(const char fileName[], const CheckpointHeader& header): fileName(fileName), ofp(fopen((this->fileName + ".tmp").c_str(), "wb")), good(ofp != NULL) {
+		char p[CHECKPOINT_HEADER_SIZE] = {};
+		memcpy(p, CHECKPOINT_MAGIC, 4);
+		memcpy(p + 4, &CHECKPOINT_VERSION, 4);
+		memcpy(p + 8, &header, sizeof(header));
+		write(p, CHECKPOINT_HEADER_SIZE);
+	}
+	~CheckpointWriter() {
+		if (ofp != NULL) fclose(ofp);
+	}
+	template<class T> void put(const T& x) {
+		write(&x, sizeof(T));
+	}
+	template<class T> void put(const std::vector<T>& v) {
+		put((unsigned long long)v.size());
+		write(v.data(), v.size() * sizeof(T));
+	}
+	// The lengths of the inner vectors first, then all their elements back to back
+	template<class T> void put(const std::vector<std::vector<T>>& vv) {
+		std::vector<unsigned long long> sizes(vv.size());
+		for (size_t i = 0; i < vv.size(); ++i)
+			sizes[i] = vv[i].size();
+		put(sizes);
+		for (const std::vector<T>& v: vv)
+			write(v.data(), v.size() * sizeof(T));
+	}
+	// Returns false if anything could not be written
+	bool close() {
+		good = ofp != NULL && fclose(ofp) == 0 && good;
+		ofp = NULL;
+		if (!good) return false;
+		const std::string tmp = fileName + ".tmp";
+		if (rename(tmp.c_str(), fileName.c_str()) != 0) {
+			// Windows does not replace an existing file
+			remove(fileName.c_str());
+			good = rename(tmp.c_str(), fileName.c_str()) == 0;
+		}
+		return good;
+	}
+private:
+	std::string fileName;
+	FILE *ofp;
+	bool good;
+	void write(const void *p, size_t n) {
+		if (good && n > 0)
+			good = fwrite(p, 1, n, ofp) == n;
+	}
+};
+
+class CheckpointReader {
+public:
+	// ok() is false if the file is missing or is not a checkpoint of this version
+	CheckpointReader(const char fileName[]): file(fileName), p(file.data()), end(p + file.size()), good(false) {
+		if (p == NULL || file.size() < CHECKPOINT_HEADER_SIZE || memcmp(p, CHECKPOINT_MAGIC, 4) != 0) return;
+		unsigned version;
+		memcpy(&version, p + 4, 4);
+		if (version != CHECKPOINT_VERSION) return;
+		memcpy(&header, p + 8, sizeof(header));
+		p += CHECKPOINT_HEADER_SIZE;
+		good = true;
+	}
+	// Becomes false once a read goes past the end of the file
+	bool ok() const {
+		return good;
+	}
+	CheckpointHeader header;
+	template<class T> void get(T& x) {
+		read(&x, sizeof(T));
+	}
+	template<class T> void get(std::vector<T>& v) {
+		unsigned long long n = 0;
+		get(n);
+		if (!good || n > (size_t)(end - p) / sizeof(T)) {
+			good = false;
+			return;
+		}
+		v.resize(n);
+		read(v.data(), n * sizeof(T));
+	}
+	template<class T> void get(std::vector<std::vector<T>>& vv) {
+		std::vector<unsigned long long> sizes;
+		get(sizes);
+		vv.resize(sizes.size());
+		for (size_t i = 0; good && i < sizes.size(); ++i) {
+			if (sizes[i] > (size_t)(end - p) / sizeof(T)) {
+				good = false;
+				return;
+			}
+			vv[i].resize(sizes[i]);
+			read(vv[i].data(), sizes[i] * sizeof(T));
+		}
+	}
+private:
+	MappedFile file;
+	const char *p, *end;
+	bool good;
+	void read(void *x, size_t n) {
+		if (!good || n > (size_t)(end - p)) {
+			good = false;
+			return;
+		}
+		if (n > 0)
+			memcpy(x, p, n);
+		p += n;
+	}
+};
+#endif
@@ -0,0 +1,65 @@
+/*
+Convert a text update log into the binary format described in BinaryFormat.hpp.
+All algorithms detect binary logs by their header and read them without parsing, so the conversion only has to be done once per log.
+
+[To compile]
+g++ -std=c++11 -O3 ConvertToBinary.cpp GraphScheduler.cpp -pthread -o ConvertToBinary
+
+[To run]
+ConvertToBinary input output
+*/
+
+#include <cstdio>
+#include <iostream>
+#include "GraphScheduler.hpp"
+#include "BinaryFormat.hpp"
+using namespace std;
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		cerr << "Usage: ConvertToBinary input output" << endl;
+		return 1;
+	}
+	GraphScheduler scheduler(argv[1]);
+	FILE *ofp = fopen(argv[2], "wb");
+	if (ofp == NULL) {
+		cerr << "Cannot write " << argv[2] << endl;
+		return 1;
+	}
+	BinaryHeader header;
+	header.version = BINARY_VERSION;
+	header.numberOfUpdates = scheduler.numberOfUpdates;
+	header.numberOfNodes = scheduler.numberOfNodes;
+	header.maxDegree = scheduler.maxDegree;
+	header.maxCardinality = scheduler.maxCardinality;
+	char headerBytes[BINARY_HEADER_SIZE];
+	encodeHeader(header, headerBytes);
+	fwrite(headerBytes, 1, BINARY_HEADER_SIZE, ofp);
+
+	vector<char> out;
+	int lastTimestamp = 0;
+	size_t bytes = BINARY_HEADER_SIZE;
+	while (scheduler.hasNext()) {
+		const EdgeUpdate& edgeUpdate = scheduler.nextUpdate();
+		putVarint(out, (edgeUpdate.e.size() << 1) | (edgeUpdate.updType == DEL ? 1 : 0));
+		Node last = 0;
+		for (const Node u: edgeUpdate.e) {
+			putVarint(out, u - last);
+			last = u;
+		}
+		if (edgeUpdate.updType == INS) {
+			putVarint(out, zigzag((int)((unsigned)edgeUpdate.timestamp - (unsigned)lastTimestamp)));
+			lastTimestamp = edgeUpdate.timestamp;
+		}
+		if (out.size() >= (1 << 20)) {
+			fwrite(out.data(), 1, out.size(), ofp);
+			bytes += out.size();
+			out.clear();
+		}
+	}
+	fwrite(out.data(), 1, out.size(), ofp);
+	bytes += out.size();
+	fclose(ofp);
+	cerr << scheduler.numberOfUpdates << " updates, " << bytes << " bytes." << endl;
+	return 0;
+}
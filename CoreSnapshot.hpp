@@ -0,0 +1,69 @@
+#ifndef __CORESNAPSHOT__
+#define __CORESNAPSHOT__
+
+#include <atomic>
+#include <thread>
+#include "Hypergraph.hpp"
+
+// Approximate core values by (dense) node ID, published by the thread that applies the updates for any number of reader threads.
+// A sequence lock guards the values: the writer changes them between beginWrite() and endWrite() and never waits for readers,
+// while a reader retries if a publication overlapped its read. So every read returns the values as of the end of one publication.
+// Values are kept in chunks that are allocated on demand and never move, so the array grows under concurrent reads.
+class CoreSnapshot {
+public:
+	CoreSnapshot(): seq(0), chunks(new std::atomic<std::atomic<unsigned> *>[DIRECTORY_SIZE]()) {}
+	~CoreSnapshot() {
+		for (unsigned i = 0; i < DIRECTORY_SIZE; ++i)
+			delete[] chunks[i].load();
+		delete[] chunks;
+	}
+	// Writer
+	void beginWrite() {
+		seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+	void set(Node u, unsigned value) {
+		std::atomic<unsigned> *chunk = chunks[u >> CHUNK_BITS].load(std::memory_order_relaxed);
+		if (chunk == NULL) {
+			chunk = new std::atomic<unsigned>[CHUNK_SIZE]();
+			chunks[u >> CHUNK_BITS].store(chunk, std::memory_order_release);
+		}
+		chunk[u & (CHUNK_SIZE - 1)].store(value, std::memory_order_relaxed);
+	}
+	void endWrite() {
+		seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	// Readers: the values of the nodes in [begin, end), all from the same publication (0 for a node that was never published).
+	// Returns the number of publications up to that one.
+	unsigned long long get(const Node *begin, const Node *end, unsigned *values) const {
+		for (int spin = 0; ; ++spin) {
+			const unsigned long long s = seq.load(std::memory_order_acquire);
+			if (!(s & 1)) {
+				for (const Node *p = begin; p != end; ++p)
+					values[p - begin] = load(*p);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (seq.load(std::memory_order_relaxed) == s)
+					return s / 2;
+			}
+			if (spin >= SPIN)
+				std::this_thread::yield();
+		}
+	}
+	unsigned get(Node u) const {
+		unsigned value;
+		get(&u, &u + 1, &value);
+		return value;
+	}
+private:
+	static const unsigned CHUNK_BITS = 16, CHUNK_SIZE = 1u << CHUNK_BITS, DIRECTORY_SIZE = 1u << (32 - CHUNK_BITS);
+	static const int SPIN = 64;
+	std::atomic<unsigned long long> seq; // Odd while a publication is in progress
+	std::atomic<std::atomic<unsigned> *> *chunks;
+	unsigned load(Node u) const {
+		const std::atomic<unsigned> *chunk = chunks[u >> CHUNK_BITS].load(std::memory_order_acquire);
+		return chunk == NULL ? 0 : chunk[u & (CHUNK_SIZE - 1)].load(std::memory_order_relaxed);
+	}
+	CoreSnapshot(const CoreSnapshot&);
+	CoreSnapshot& operator=(const CoreSnapshot&);
+};
+#endif
@@ -1,382 +1,959 @@
-/*
-Our fully dynamic algorithm.
-The code includes various functional blocks. Uncomment respective parts to examine different aspects of the execution.
-
-[To compile]
-g++ -std=c++11 -O3 FullyDynamic.cpp GraphScheduler.cpp Hypergraph.cpp HypergraphCoreDecomp.cpp -o FullyDynamic -lpsapi
-
-[To run]
-FullyDynamic epsilon lambda alpha filename
-
-[Format of input]
-The file should contain an update in each line.
-Hyperedge insertion: + [node IDs] timestamp
-Hyperedge deletion: - [node IDs]
-So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
-The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
-When deleting a hyperedge, make sure that exactly the same sequence appeared in an insertion update before.
-Therefore, it is recommended that in each line, the node IDs are sorted in some particular order, e.g., increasing order.
-
-[Remark]
-This program is developed on Windows. "-lpsapi" is related to reporting memory usage. You may have to remove it and "OutputMemory.cpp" (which includes a function outputMemory()) and reimplement this part when you want to compile and run the code on a different operating system.
-*/
-
-#include <cstdio>
-#include <cmath>
-#include <ctime>
-#include <cassert>
-#include <iostream>
-#include <unordered_set>
-#include <unordered_map>
-#include <algorithm>
-#include "Hypergraph.hpp"
-#include "GraphScheduler.hpp"
-#include "HypergraphCoreDecomp.hpp"
-#include "OutputMemory.cpp"
-using namespace std;
-
-class FullyDynamic {
-public:
-	FullyDynamic(double epsilon, double lambda, double alpha, char fileName[]):
-		epsilon(epsilon), lambda(lambda), alpha(alpha), scheduler(fileName) {
-		initialize();
-	}
-	void run() {
-	//	FILE *ofpVal = fopen("StatFullyDynamicCoreValue.txt", "w");
-		FILE *ofpTime = fopen("StatFullyDynamicTime.txt", "w");
-	//	FILE *ofpDetail = fopen("StatFullyDynamicDetail.txt", "w");
-		int cnt = 0;
-		time_t t0 = clock(), totalTime = 0;
-		int lastUpdTimestamp;
-		while (scheduler.hasNext()) {
-			EdgeUpdate edgeUpdate = scheduler.nextUpdate();
-			if (edgeUpdate.updType == INS)
-				// h.insertEdge(edgeUpdate.e);
-				insertEdge(edgeUpdate.e);
-			else
-				// h.deleteEdge(edgeUpdate.e);
-				deleteEdge(edgeUpdate.e);
-			++cnt;
-
-			if (cnt % 100000 == 0) {
-				cerr << cnt << "...\t";
-				// Block: print all b[t][u] and c[u] every 100000 updates
-				time_t t1 = clock();
-				fprintf(ofpTime, "%d\n", t1 - t0);
-				// fprintf(ofpVal, "%d\n", cnt);
-
-				/*
-				// Block: observe gracefully degrading ratios (3-dimensional figures)
-				// Run the static exact algorithm
-				HypergraphCoreDecomp hcd(h);
-				hcd.solve();
-				unordered_map<int, int> coreCount, coreCountApprox;
-				for (auto& p: hcd.c) {
-					const Node u = p.first;
-					if (hcd.c[u] > 0) {
-						if (!coreCount.count(hcd.c[u]))
-							coreCount[hcd.c[u]] = 1;
-						else
-							++coreCount[hcd.c[u]];
-						if (!coreCountApprox.count(b[tau][u]))
-							coreCountApprox[b[tau][u]] = 1;
-						else
-							++coreCountApprox[b[tau][u]];
-					}
-				}
-				for (auto& p: coreCount)
-					fprintf(ofpVal, "%d %d\n", p.first, p.second);
-				fprintf(ofpVal, "-1\n");
-				for (auto& p: coreCountApprox)
-					fprintf(ofpVal, "%d %d\n", p.first, p.second);
-				fprintf(ofpVal, "-1\n");
-
-				vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
-				int cntNonZero = 0;
-				for (auto& p: hcd.c) {
-					const Node u = p.first;
-					if (hcd.c[u] > 0) {
-						++cntNonZero;
-						for (int t = 1; t <= tau; ++t) {
-							double err = max(((double)hcd.c[u]) / b[t][u], ((double)b[t][u]) / hcd.c[u]);
-							if (maxErr[t] < err)
-								maxErr[t] = err;
-							avgErr[t] += err;
-						}
-					}
-				}
-				for (int t = 1; t <= tau; ++t)
-					avgErr[t] /= cntNonZero;
-				for (int t = 1; t <= tau; ++t)
-					fprintf(ofpDetail, "%.9f%c", maxErr[t], t == tau ? '\n' : ' ');
-				for (int t = 1; t <= tau; ++t)
-					fprintf(ofpDetail, "%.9f%c", avgErr[t], t == tau ? '\n' : ' ');
-				*/
-				t0 = clock();
-			}
-
-			/*
-			// Block: compare the hypergraph model with the normal graph model by examining the final snapshot in two models
-			// Construct the normal graph
-			Hypergraph normalG;
-			for (auto p: h.edge2id) {
-				Hyperedge hyperedge = p.first;
-				for (Hyperedge::iterator iter1 = hyperedge.begin(); iter1 != hyperedge.end(); ++iter1) {
-					for (Hyperedge::iterator iter2 = hyperedge.begin(); iter2 != iter1; ++iter2) {
-						Hyperedge e;
-						e.push_back(*iter2);
-						e.push_back(*iter1);
-						normalG.insertEdge(e);
-					}
-				}
-			}
-			// Compute core values
-			HypergraphCoreDecomp hcd(h), hcdn(normalG);
-			hcd.solve();
-			hcdn.solve();
-			char fileName[50] = "StatHyperAndNormalCoreValue.txt";
-			FILE *ofpCmpModel = fopen(fileName, "w");
-			for (auto& p: hcd.c) {
-				fprintf(ofpCmpModel, "%d\t%d\t%d\t%d\n", p.first, p.second, getApproxCoreVal(p.first), hcdn.c[p.first]);
-			}
-			fclose(ofpCmpModel);
-			*/
-		}
-	//	fclose(ofpVal);
-		fclose(ofpTime);
-	//	fclose(ofpDetail);
-
-		/*
-		// Block: compare between different parameters
-		FILE *ofpComp = fopen("StatFullyDynamic.txt", "w");
-		fprintf(ofpComp, "alpha = %f\n", alpha);
-		fprintf(ofpComp, "lambda = %f\n", lambda);
-		fprintf(ofpComp, "total time = %d ms\n", clock());
-		fprintf(ofpComp, "total number of updates = %d\n", cnt);
-		double maxErr = 0, avgErr = 0;
-		int cntNonZero = 0;
-		HypergraphCoreDecomp hcd(h);
-		hcd.solve();
-		for (auto& p: hcd.c) {
-			const Node u = p.first;
-			assert((hcd.c[u] == 0 && b[tau][u] == 0) || (hcd.c[u] > 0 && b[tau][u] > 0));
-			if (hcd.c[u] > 0) {
-				++cntNonZero;
-				double err = max((double)hcd.c[u] / b[tau][u], (double)b[tau][u] / hcd.c[u]);
-				maxErr = max(maxErr, err);
-				avgErr += err;
-			}
-		}
-		avgErr /= cntNonZero;
-		fprintf(ofpComp, "max error = %.9f\n", maxErr);
-		fprintf(ofpComp, "avg error = %.9f\n", avgErr);
-		fclose(ofpComp);
-		*/
-
-		/*
-		// Block: show that a large tau is unnecessary
-		vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
-		int cntNonZero = 0;
-		HypergraphCoreDecomp hcd(h);
-		hcd.solve();
-		for (auto& p: hcd.c) {
-			const Node u = p.first;
-			assert((hcd.c[u] == 0 && b[tau][u] == 0) || (hcd.c[u] > 0 && b[tau][u] > 0));
-			if (hcd.c[u] > 0) {
-				++cntNonZero;
-				for (int t = 1; t <= tau; ++t) {
-					if (maxErr[t] < max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]))
-						maxErr[t] = max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]);
-					avgErr[t] += max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]);
-				}
-			}
-		}
-		for (int t = 1; t <= tau; ++t)
-			avgErr[t] /= cntNonZero;
-
-		FILE *ofpLargeTau = fopen("LargeTauIsUnnecessaryFullyDynamic.txt", "w");
-		fprintf(ofpLargeTau, "%d\n", tau);
-		for (int t = 1; t <= tau; ++t)
-			fprintf(ofpLargeTau, "%.9f %.9f\n", maxErr[t], avgErr[t]);
-		fclose(ofpLargeTau);*/
-	}
-	unsigned getApproxCoreVal(Node u) {
-		return b[tau][u];
-	}
-	void debug() {
-		for (int i = 1; i <= 100; ++i)
-			cerr << getApproxCoreVal(i) << ' ';
-		cerr << endl;
-	}
-	Hypergraph h;
-private:
-	double epsilon, lambda, alpha;
-	GraphScheduler scheduler;
-
-	int tau;
-	vector<unsigned> succ, pred;
-	vector<unordered_map<Node, unsigned>> b, sigma, rho;
-	void initialize() {
-		// alpha should be r * (1 + 3 * epsilon) where r is maximum edge cardinality.
-		// But we can slightly reduce it when r is too large.
-		// alpha is decided by input.
-
-		// alpha = 2 * (1 + 3 * epsilon);
-		tau = ceil(0.15 * log(scheduler.numberOfNodes) / log(1.0 + epsilon));
-
-		// Build succ and pred
-		vector<unsigned> Lambda(1, 0);
-		int i = 0;
-		while (Lambda[i] <= scheduler.maxDegree) {
-			Lambda.push_back(max((unsigned)(Lambda[i] * (1.0 + lambda)), Lambda[i] + 1));
-			++i;
-		}
-		succ = pred = vector<unsigned>(Lambda[i] + 1);
-		for (int j = 0; j < i; ++j)
-			succ[Lambda[j]] = Lambda[j + 1], pred[Lambda[j + 1]] = Lambda[j];
-		b.resize(tau + 1);
-		sigma.resize(tau + 1);
-		rho.resize(tau + 1);
-		cerr << "Lambda: ";
-		for (auto& lambda: Lambda) cerr << lambda << ' ';
-		cerr << endl;
-		cerr << "# of nodes = " << scheduler.numberOfNodes << endl;
-		cerr << "tau = " << tau << endl;
-		cerr << "max degree = " << scheduler.maxDegree << endl;
-	}
-	void insertEdge(const Hyperedge& e) {
-	//	cerr << "Insert an edge" << endl;
-		h.insertEdge(e);
-		unordered_set<Node> bad, bad2;
-		for (const Node u: e)
-			++sigma[1][u], ++rho[1][u], bad.insert(u);
-		for (unsigned t = 1; t <= tau; ++t) {
-			bad2.clear();
-			if (t < tau) {
-				unsigned b_e = INT_MAX;
-				for (const Node u: e)
-					b_e = min(b_e, b[t][u]);
-				for (const Node u: e) {
-					if (b_e >= succ[b[t + 1][u]])
-						++sigma[t + 1][u], bad2.insert(u);
-					if (b_e >= b[t + 1][u])
-						++rho[t + 1][u];
-				}
-			}
-			for (const Node u: bad)
-				if (sigma[t][u] >= (unsigned)(alpha * succ[b[t][u]]))
-					promote(t, u, bad2);
-			swap(bad, bad2);
-		}
-	}
-	void promote(const unsigned t, const Node u, unordered_set<Node>& bad2) {
-	//	cerr << "Promote " << t << ' ' << u << ' ' << newEdgeId << endl;
-		unsigned old_b_t_u = b[t][u];
-		b[t][u] = succ[b[t][u]];
-		updateSigmaAndRho(t, u);
-	//	cerr << "b[" << t << "][" << u << "] = " << b[t][u] << ", sigma[" << t << "][" << u << "] = " << sigma[t][u] << endl;
-		if (t == tau) return;
-		for (const unsigned eId: h.eList[u]) {
-	//		cerr << "eId = " << eId << endl;
-			const Hyperedge& e = h.edgePool[eId];
-			unsigned old_b_e = INT_MAX;
-			for (const Node v: e)
-				if (v != u)
-					old_b_e = min(old_b_e, b[t][v]);
-			unsigned new_b_e = min(old_b_e, b[t][u]);
-			old_b_e = min(old_b_e, old_b_t_u);
-			if (new_b_e == old_b_e) continue;
-			for (const Node v: e) {
-				if (old_b_e < succ[b[t + 1][v]] && succ[b[t + 1][v]] <= new_b_e)
-					++sigma[t + 1][v], bad2.insert(v);
-				if (old_b_e < b[t + 1][v] && b[t + 1][v] <= new_b_e)
-					++rho[t + 1][v];
-			}
-		}
-	//	cerr << "Promote finished." << endl;
-	}
-	void deleteEdge(const Hyperedge& e) {
-	//	cerr << "Delete an edge" << endl;
-		h.deleteEdge(e);
-		unordered_set<Node> bad, bad2;
-		for (const Node u: e)
-			--sigma[1][u], --rho[1][u], bad.insert(u);
-		for (unsigned t = 1; t <= tau; ++t) {
-			bad2.clear();
-			if (t < tau) {
-				unsigned b_e = INT_MAX;
-				for (const Node u: e)
-					b_e = min(b_e, b[t][u]);
-				for (const Node u: e) {
-					if (b_e >= succ[b[t + 1][u]])
-						--sigma[t + 1][u];
-					if (b_e >= b[t + 1][u])
-						--rho[t + 1][u], bad2.insert(u);
-				}
-			}
-			for (const Node u: bad)
-				if (rho[t][u] < b[t][u])
-					demote(t, u, bad2);
-			swap(bad, bad2);
-		}
-	}
-	void demote(const unsigned t, const Node u, unordered_set<Node>& bad2) {
-	//	cerr << "Demote " << t << ' ' << u << endl;
-		unsigned old_b_t_u = b[t][u];
-		b[t][u] = pred[b[t][u]];
-		updateSigmaAndRho(t, u);
-		if (t == tau) return;
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge& e = h.edgePool[eId];
-			unsigned old_b_e = INT_MAX;
-			for (const Node v: e)
-				if (v != u)
-					old_b_e = min(old_b_e, b[t][v]);
-			unsigned new_b_e = min(old_b_e, b[t][u]);
-			old_b_e = min(old_b_e, old_b_t_u);
-			if (new_b_e == old_b_e) continue;
-			for (const Node v: e) {
-				if (new_b_e < succ[b[t + 1][v]] && succ[b[t + 1][v]] <= old_b_e)
-					--sigma[t + 1][v];
-				if (new_b_e < b[t + 1][v] && b[t + 1][v] <= old_b_e)
-					--rho[t + 1][v], bad2.insert(v);
-			}
-		}
-	}
-	void updateSigmaAndRho(unsigned t, Node u) {
-		sigma[t][u] = rho[t][u] = 0;
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge& e = h.edgePool[eId];
-			unsigned b_e = INT_MAX;
-			if (t > 1)
-				for (const Node v: e)
-					b_e = min(b_e, b[t - 1][v]);
-			if (b_e >= succ[b[t][u]]) ++sigma[t][u];
-			if (b_e >= b[t][u]) ++rho[t][u];
-		}
-	}
-};
-
-int main(int argc, char **argv) {
-	double epsilon = atof(argv[1]);
-	double lambda = atof(argv[2]);
-	double alpha = atof(argv[3]);
-	char *fileName = argv[4];
-	FullyDynamic fullyDynamic(epsilon, lambda, alpha, fileName);
-	time_t t = clock();
-	fullyDynamic.run();
-	t = clock() - t;
-	FILE *ofp = fopen("StatTimeMemory.txt", "a");
-	fprintf(ofp, "Round\t%.2f\t%f\t", epsilon, t / 1000.0);
-	cerr << t << " ms." << endl;
-//	fullyDynamic.debug();
-//	Node u;
-//	while (cin >> u)
-//		cout << fullyDynamic.getApproxCoreVal(u) << endl;
-	fullyDynamic.debug();
-	cerr << "Finished!!!" << endl;
-	double mem = outputMemory();
-	fprintf(ofp, "%f\n", mem);
-	fclose(ofp);
-	return 0;
-}
+/*
+Our fully dynamic algorithm.
+The code includes various functional blocks. Uncomment respective parts to examine different aspects of the execution.
+
+[To compile]
+g++ -std=c++11 -O3 FullyDynamic.cpp GraphScheduler.cpp Hypergraph.cpp HypergraphCoreDecomp.cpp -pthread -o FullyDynamic -lpsapi
+
+[To run]
+FullyDynamic epsilon lambda alpha filename [stream] [collapse] [batch=size | pipeline=size] [report=updates] [interval=seconds] [values=filename] [checkpoint=filename] [restore=filename]
+A filename of "-" (or a named pipe) reads the updates live, as a producer writes them.
+checkpoint= saves the state at every report and at the end; restore= resumes from such a checkpoint with the rest of the same log.
+
+[Format of input]
+The file should contain an update in each line.
+Hyperedge insertion: + [node IDs] timestamp
+Hyperedge deletion: - [node IDs]
+So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
+The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
+When deleting a hyperedge, make sure that exactly the same sequence appeared in an insertion update before.
+Therefore, it is recommended that in each line, the node IDs are sorted in some particular order, e.g., increasing order.
+
+[Remark]
+This program is developed on Windows. "-lpsapi" is related to reporting memory usage. You may have to remove it and "OutputMemory.cpp" (which includes a function outputMemory()) and reimplement this part when you want to compile and run the code on a different operating system.
+*/
+
+#include <cstdio>
+#include <cmath>
+#include <climits>
+#include <ctime>
+#include <cassert>
+#include <iostream>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include "Hypergraph.hpp"
+#include "GraphScheduler.hpp"
+#include "HypergraphCoreDecomp.hpp"
+#include "Worklist.hpp"
+#include "ThreadPool.hpp"
+#include "UpdateStats.hpp"
+#include "CoreSnapshot.hpp"
+#include "Checkpoint.hpp"
+#include "OutputMemory.cpp"
+using namespace std;
+
+class FullyDynamic {
+public:
+	// With batchSize > 0, run() hands the updates to applyBatch() in batches of up to batchSize updates.
+	// Otherwise, with pipelineSize > 0, it hands them to applyPipelined() in windows of up to pipelineSize updates.
+	// With checkpoint, the state is restored from that file (see saveCheckpoint()) and only the rest of the log is read;
+	// if the file is missing, was written with other parameters or on another log, the log is read from the beginning.
+	FullyDynamic(double epsilon, double lambda, double alpha, char fileName[], unsigned schedulerFlags = 0, size_t batchSize = 0, size_t pipelineSize = 0, const char *checkpoint = NULL):
+		epsilon(epsilon), lambda(lambda), alpha(alpha), scheduler(fileName, schedulerFlags | DENSE_IDS | EDGE_IDS | NO_PRESCAN | (checkpoint != NULL ? DEFERRED : 0)), batchSize(batchSize), pipelineSize(pipelineSize), pool(NULL) {
+		if (checkpoint != NULL && loadCheckpoint(checkpoint))
+			return;
+		if (checkpoint != NULL) {
+			cerr << "Cannot restore from " << checkpoint << ", reading " << fileName << " from the beginning" << endl;
+			scheduler.start();
+		}
+		initialize();
+	}
+	~FullyDynamic() {
+		delete pool;
+	}
+	// Statistics are written every reportEvery updates and, with reportInterval > 0, at least every reportInterval seconds
+	// (checked whenever an update arrives). With valuesFile, each report also replaces valuesFile with the current approximate core values,
+	// and with checkpointFile, it saves a checkpoint there, as does the end of the log.
+	void run(size_t reportEvery = 100000, double reportInterval = 0, const char *valuesFile = NULL, const char *checkpointFile = NULL) {
+	//	FILE *ofpVal = fopen("StatFullyDynamicCoreValue.txt", "w");
+		FILE *ofpTime = fopen("StatFullyDynamicTime.txt", "w");
+	//	FILE *ofpDetail = fopen("StatFullyDynamicDetail.txt", "w");
+		int cnt = 0;
+		time_t t0 = clock(), totalTime = 0;
+		int lastUpdTimestamp;
+		UpdateStats stats(reportEvery, reportInterval);
+		vector<EdgeUpdate> inserts, deletes, pipelined;
+		Worklist batched; // IDs of the edges in the current batch or window
+		auto flushBatch = [&]() {
+			applyBatch(inserts, deletes);
+			for (const EdgeUpdate& update: inserts)
+				stats.applied(update);
+			for (const EdgeUpdate& update: deletes)
+				stats.applied(update);
+			inserts.clear(), deletes.clear(), batched.clear();
+		};
+		auto flushWindow = [&]() {
+			applyPipelined(pipelined);
+			for (const EdgeUpdate& update: pipelined)
+				stats.applied(update);
+			pipelined.clear(), batched.clear();
+		};
+		while (true) {
+			// On a live input, a report that falls due while the writer is quiet is not put off until the next update
+			const bool idle = scheduler.live() && reportInterval > 0 && !scheduler.ready(stats.deadline());
+			if (!idle) {
+				if (!scheduler.hasNext()) break;
+				const EdgeUpdate& edgeUpdate = scheduler.nextUpdate();
+				if (batchSize > 0) {
+					// A batch must not touch an edge ID twice (IDs are recycled), so such an update starts the next batch
+					if (batched.contains(edgeUpdate.eId))
+						flushBatch();
+					(edgeUpdate.updType == INS ? inserts : deletes).push_back(edgeUpdate);
+					batched.insert(edgeUpdate.eId);
+				} else if (pipelineSize > 0) {
+					// The same goes for a window, and an update that adds or removes a parallel copy of a live record is applied on its own
+					if (batched.contains(edgeUpdate.eId))
+						flushWindow();
+					if (edgeUpdate.eId < h.edgeIdCounter && h.edgeMultiplicity[edgeUpdate.eId] > (edgeUpdate.updType == DEL ? 1u : 0u)) {
+						flushWindow();
+						if (edgeUpdate.updType == INS)
+							insertEdge(edgeUpdate.e, edgeUpdate.eId);
+						else
+							deleteEdge(edgeUpdate.e, edgeUpdate.eId);
+						stats.applied(edgeUpdate);
+					} else {
+						pipelined.push_back(edgeUpdate);
+						batched.insert(edgeUpdate.eId);
+					}
+				} else {
+					if (edgeUpdate.updType == INS)
+						// h.insertEdge(edgeUpdate.e, edgeUpdate.eId);
+						insertEdge(edgeUpdate.e, edgeUpdate.eId);
+					else
+						// h.deleteEdgeById(edgeUpdate.eId);
+						deleteEdge(edgeUpdate.e, edgeUpdate.eId);
+					stats.applied(edgeUpdate);
+				}
+				++cnt;
+			}
+			// On a live input, a batch or window does not wait for updates that have not arrived yet
+			const bool report = stats.due(cnt), drained = scheduler.live() && scheduler.queued() == 0;
+			if (batchSize > 0 && (batched.size() == batchSize || report || drained))
+				flushBatch();
+			if (pipelineSize > 0 && (batched.size() == pipelineSize || report || drained))
+				flushWindow();
+
+			if (report) {
+				stats.report(cnt);
+				if (valuesFile != NULL)
+					writeCoreValues(valuesFile);
+				if (checkpointFile != NULL && !saveCheckpoint(checkpointFile))
+					cerr << "Cannot write the checkpoint " << checkpointFile << endl;
+				// Block: print all b[t][u] and c[u] every 100000 updates
+				time_t t1 = clock();
+				fprintf(ofpTime, "%d\n", t1 - t0);
+				// fprintf(ofpVal, "%d\n", cnt);
+
+				/*
+				// Block: observe gracefully degrading ratios (3-dimensional figures)
+				// Run the static exact algorithm
+				HypergraphCoreDecomp hcd(h);
+				hcd.solve();
+				unordered_map<int, int> coreCount, coreCountApprox;
+				for (auto& p: hcd.c) {
+					const Node u = p.first;
+					if (hcd.c[u] > 0) {
+						if (!coreCount.count(hcd.c[u]))
+							coreCount[hcd.c[u]] = 1;
+						else
+							++coreCount[hcd.c[u]];
+						if (!coreCountApprox.count(Lambda[b[at(u, tau)]]))
+							coreCountApprox[Lambda[b[at(u, tau)]]] = 1;
+						else
+							++coreCountApprox[Lambda[b[at(u, tau)]]];
+					}
+				}
+				for (auto& p: coreCount)
+					fprintf(ofpVal, "%d %d\n", p.first, p.second);
+				fprintf(ofpVal, "-1\n");
+				for (auto& p: coreCountApprox)
+					fprintf(ofpVal, "%d %d\n", p.first, p.second);
+				fprintf(ofpVal, "-1\n");
+
+				vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
+				int cntNonZero = 0;
+				for (auto& p: hcd.c) {
+					const Node u = p.first;
+					if (hcd.c[u] > 0) {
+						++cntNonZero;
+						for (int t = 1; t <= tau; ++t) {
+							double err = max(((double)hcd.c[u]) / Lambda[b[at(u, t)]], ((double)Lambda[b[at(u, t)]]) / hcd.c[u]);
+							if (maxErr[t] < err)
+								maxErr[t] = err;
+							avgErr[t] += err;
+						}
+					}
+				}
+				for (int t = 1; t <= tau; ++t)
+					avgErr[t] /= cntNonZero;
+				for (int t = 1; t <= tau; ++t)
+					fprintf(ofpDetail, "%.9f%c", maxErr[t], t == tau ? '\n' : ' ');
+				for (int t = 1; t <= tau; ++t)
+					fprintf(ofpDetail, "%.9f%c", avgErr[t], t == tau ? '\n' : ' ');
+				*/
+				t0 = clock();
+			}
+
+			/*
+			// Block: compare the hypergraph model with the normal graph model by examining the final snapshot in two models
+			// Construct the normal graph
+			Hypergraph normalG;
+			for (unsigned eId = 0; eId < h.edgeIdCounter; ++eId) {
+				const EdgeRange hyperedge = h.edge(eId);
+				for (const Node *iter1 = hyperedge.begin(); iter1 != hyperedge.end(); ++iter1) {
+					for (const Node *iter2 = hyperedge.begin(); iter2 != iter1; ++iter2) {
+						Hyperedge e;
+						e.push_back(*iter2);
+						e.push_back(*iter1);
+						normalG.insertEdge(e);
+					}
+				}
+			}
+			// Compute core values
+			HypergraphCoreDecomp hcd(h), hcdn(normalG);
+			hcd.solve();
+			hcdn.solve();
+			char fileName[50] = "StatHyperAndNormalCoreValue.txt";
+			FILE *ofpCmpModel = fopen(fileName, "w");
+			for (auto& p: hcd.c) {
+				fprintf(ofpCmpModel, "%d\t%d\t%d\t%d\n", scheduler.originalId(p.first), p.second, Lambda[b[at(p.first, tau)]], hcdn.c[p.first]);
+			}
+			fclose(ofpCmpModel);
+			*/
+		}
+		if (!inserts.empty() || !deletes.empty())
+			flushBatch();
+		if (!pipelined.empty())
+			flushWindow();
+		if (valuesFile != NULL)
+			writeCoreValues(valuesFile);
+		if (checkpointFile != NULL && !saveCheckpoint(checkpointFile))
+			cerr << "Cannot write the checkpoint " << checkpointFile << endl;
+	//	fclose(ofpVal);
+		fclose(ofpTime);
+	//	fclose(ofpDetail);
+
+		/*
+		// Block: compare between different parameters
+		FILE *ofpComp = fopen("StatFullyDynamic.txt", "w");
+		fprintf(ofpComp, "alpha = %f\n", alpha);
+		fprintf(ofpComp, "lambda = %f\n", lambda);
+		fprintf(ofpComp, "total time = %d ms\n", clock());
+		fprintf(ofpComp, "total number of updates = %d\n", cnt);
+		double maxErr = 0, avgErr = 0;
+		int cntNonZero = 0;
+		HypergraphCoreDecomp hcd(h);
+		hcd.solve();
+		for (auto& p: hcd.c) {
+			const Node u = p.first;
+			assert((hcd.c[u] == 0 && Lambda[b[at(u, tau)]] == 0) || (hcd.c[u] > 0 && Lambda[b[at(u, tau)]] > 0));
+			if (hcd.c[u] > 0) {
+				++cntNonZero;
+				double err = max((double)hcd.c[u] / Lambda[b[at(u, tau)]], (double)Lambda[b[at(u, tau)]] / hcd.c[u]);
+				maxErr = max(maxErr, err);
+				avgErr += err;
+			}
+		}
+		avgErr /= cntNonZero;
+		fprintf(ofpComp, "max error = %.9f\n", maxErr);
+		fprintf(ofpComp, "avg error = %.9f\n", avgErr);
+		fclose(ofpComp);
+		*/
+
+		/*
+		// Block: show that a large tau is unnecessary
+		vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
+		int cntNonZero = 0;
+		HypergraphCoreDecomp hcd(h);
+		hcd.solve();
+		for (auto& p: hcd.c) {
+			const Node u = p.first;
+			assert((hcd.c[u] == 0 && Lambda[b[at(u, tau)]] == 0) || (hcd.c[u] > 0 && Lambda[b[at(u, tau)]] > 0));
+			if (hcd.c[u] > 0) {
+				++cntNonZero;
+				for (int t = 1; t <= tau; ++t) {
+					if (maxErr[t] < max((double)hcd.c[u] / Lambda[b[at(u, t)]], (double)Lambda[b[at(u, t)]] / hcd.c[u]))
+						maxErr[t] = max((double)hcd.c[u] / Lambda[b[at(u, t)]], (double)Lambda[b[at(u, t)]] / hcd.c[u]);
+					avgErr[t] += max((double)hcd.c[u] / Lambda[b[at(u, t)]], (double)Lambda[b[at(u, t)]] / hcd.c[u]);
+				}
+			}
+		}
+		for (int t = 1; t <= tau; ++t)
+			avgErr[t] /= cntNonZero;
+
+		FILE *ofpLargeTau = fopen("LargeTauIsUnnecessaryFullyDynamic.txt", "w");
+		fprintf(ofpLargeTau, "%d\n", tau);
+		for (int t = 1; t <= tau; ++t)
+			fprintf(ofpLargeTau, "%.9f %.9f\n", maxErr[t], avgErr[t]);
+		fclose(ofpLargeTau);*/
+	}
+	unsigned getApproxCoreVal(Node u) {
+		// u is a node ID of the input. Only for the thread that runs run(); other threads use readApproxCoreVal().
+		Node v;
+		if (!scheduler.denseId(u, v) || at(v, tau) >= b.size())
+			return 0;
+		return Lambda[b[at(v, tau)]];
+	}
+	// Any thread may call these while run() applies updates. They return the values as of the last update, batch or window
+	// that has been applied completely, never those of one in progress, and do not hold up the updates.
+	unsigned readApproxCoreVal(Node u) {
+		Node v;
+		return scheduler.denseId(u, v) ? snapshot.get(v) : 0;
+	}
+	// The values of several nodes, all from the same snapshot. Returns the number of snapshots published up to that one.
+	unsigned long long readApproxCoreVals(const vector<Node>& nodes, vector<unsigned>& values) {
+		vector<Node> dense(nodes.size());
+		vector<bool> known(nodes.size());
+		for (size_t i = 0; i < nodes.size(); ++i)
+			known[i] = scheduler.denseId(nodes[i], dense[i]);
+		values.resize(nodes.size());
+		const unsigned long long epoch = snapshot.get(dense.data(), dense.data() + dense.size(), values.data());
+		for (size_t i = 0; i < nodes.size(); ++i)
+			if (!known[i])
+				values[i] = 0;
+		return epoch;
+	}
+	// Write a line "node value" for every node with a positive approximate core value, replacing the previous snapshot at once
+	void writeCoreValues(const char *fileName) {
+		FILE *ofp = fopen((string(fileName) + ".tmp").c_str(), "w");
+		if (ofp == NULL) return;
+		for (Node u = 0; u < b.size() / (tau + 1); ++u)
+			if (b[at(u, tau)] > 0)
+				fprintf(ofp, "%u %u\n", scheduler.originalId(u), Lambda[b[at(u, tau)]]);
+		fclose(ofp);
+		UpdateStats::publish(fileName);
+	}
+	// Save the state after the updates applied so far, together with where they end in the log, replacing the previous checkpoint at once.
+	// Only between updates: run() applies a pending batch or window first. Returns false if the file could not be written.
+	bool saveCheckpoint(const char *fileName) {
+		CheckpointHeader header = {};
+		strncpy(header.algorithm, "FullyDynamic", sizeof(header.algorithm));
+		header.parameters[0] = epsilon, header.parameters[1] = lambda, header.parameters[2] = alpha;
+		header.offset = scheduler.offset();
+		header.updates = scheduler.updates();
+		header.logHash = scheduler.prefixHash(header.offset);
+		header.lastTimestamp = scheduler.lastInsertionTimestamp();
+		header.schedulerFlags = scheduler.idFlags();
+		CheckpointWriter out(fileName, header);
+		out.put(scheduler.originalIds(h.nNodes));
+		h.save(out);
+		out.put(tau);
+		out.put(Lambda);
+		out.put(b);
+		out.put(sigma);
+		out.put(rho);
+		out.put(edgeMin);
+		out.put(edgeMinCount);
+		out.put(hist);
+		return out.close();
+	}
+	// Restore the state saved by saveCheckpoint() and let the scheduler (constructed with DEFERRED) go on right after it in the log.
+	// Returns false, with nothing changed, if fileName is missing or is not a checkpoint of this algorithm with the same parameters on this log.
+	// Exits if it was taken with other ID flags (see GraphScheduler::idFlags()), e.g. with collapse when this run is without.
+	bool loadCheckpoint(const char *fileName) {
+		CheckpointReader in(fileName);
+		const double parameters[3] = {epsilon, lambda, alpha};
+		if (!in.ok() || strncmp(in.header.algorithm, "FullyDynamic", sizeof(in.header.algorithm)) != 0
+			|| memcmp(in.header.parameters, parameters, sizeof(parameters)) != 0)
+			return false;
+		// Neither a checkpoint taken on a live input nor a live input has the bytes to compare
+		if (in.header.logHash != 0 && !scheduler.live() && in.header.logHash != scheduler.prefixHash(in.header.offset)) {
+			cerr << "The checkpoint " << fileName << " was taken on another log" << endl;
+			return false;
+		}
+		// The saved edge IDs only fit the ID model they were handed out under (see GraphScheduler::restoreEdges())
+		if (in.header.schedulerFlags != scheduler.idFlags()) {
+			cerr << "The checkpoint " << fileName << " was taken " << (in.header.schedulerFlags & COLLAPSE_PARALLEL ? "with" : "without")
+				<< " collapse; pass the same options to restore it" << endl;
+			exit(1);
+		}
+		vector<Node> originalIds;
+		in.get(originalIds);
+		h.load(in);
+		in.get(tau);
+		in.get(Lambda);
+		in.get(b);
+		in.get(sigma);
+		in.get(rho);
+		in.get(edgeMin);
+		in.get(edgeMinCount);
+		in.get(hist);
+		if (!in.ok()) {
+			cerr << "The checkpoint " << fileName << " is truncated" << endl;
+			exit(1);
+		}
+		scheduler.start(in.header.offset, in.header.updates, in.header.lastTimestamp, &originalIds, &h);
+		for (Node u = 0; u < b.size() / (tau + 1); ++u)
+			topChanged.insert(u);
+		publish();
+		cerr << "Restored " << in.header.updates << " updates from " << fileName << ", tau = " << tau << endl;
+		return true;
+	}
+	void debug() {
+		for (int i = 1; i <= 100; ++i)
+			cerr << getApproxCoreVal(i) << ' ';
+		cerr << endl;
+	}
+	// Apply insertions and deletions of distinct edge IDs at once, then settle the levels one after another.
+	// At level t, every affected node moves b[t] until it can be neither promoted nor demoted. This only depends on level t - 1,
+	// so the nodes are handled in parallel. Afterwards the edges around the nodes that moved pass the change on to level t + 1.
+	// Every node that is looked at ends up satisfying both conditions, which is what the approximation guarantee rests on.
+	void applyBatch(const vector<EdgeUpdate>& inserts, const vector<EdgeUpdate>& deletes) {
+		for (const EdgeUpdate& update: inserts)
+			prepareInsertion(update.e);
+		for (const EdgeUpdate& update: deletes)
+			h.deleteEdgeById(update.eId);
+		for (const EdgeUpdate& update: inserts) {
+			h.insertEdge(update.e, update.eId);
+			finishInsertion(update.e);
+		}
+		bad.clear();
+		for (const EdgeUpdate& update: inserts)
+			for (const Node u: update.e)
+				moveEdge(1, u, -1, topBucket(), 1, bad, NULL);
+		for (const EdgeUpdate& update: deletes)
+			for (const Node u: update.e)
+				moveEdge(1, u, topBucket(), -1, 1, bad, NULL);
+		vector<LadderIndex> before;
+		for (unsigned t = 1; t <= tau; ++t) {
+			bad2.clear();
+			if (t < tau) {
+				// The edges of the batch enter or leave level t + 1 with b_e as it is before level t moves
+				for (const EdgeUpdate& update: inserts)
+					shiftEdge(t, h.edge(update.eId), -1, updateEdgeMin(t, update.eId), 1, bad2);
+				for (const EdgeUpdate& update: deletes) {
+					LadderIndex b_e = UCHAR_MAX;
+					for (const Node u: update.e)
+						b_e = min(b_e, b[at(u, t)]);
+					EdgeRange e = {update.e.data(), update.e.data() + update.e.size()};
+					shiftEdge(t, e, b_e, -1, 1, bad2);
+				}
+			}
+			before.resize(bad.size());
+			threads().parallelFor(bad.size(), [&](size_t j, unsigned) {
+				before[j] = b[at(bad[j], t)];
+				settle(t, bad[j]);
+			}, 16);
+			if (t < tau) {
+				changedEdges.clear();
+				for (size_t j = 0; j < bad.size(); ++j)
+					if (b[at(bad[j], t)] != before[j])
+						for (const unsigned eId: h.eList[bad[j]])
+							changedEdges.insert(eId);
+				for (const unsigned eId: changedEdges) {
+					const LadderIndex old_b_e = edgeMin[(size_t)eId * tau + t], new_b_e = updateEdgeMin(t, eId);
+					if (new_b_e != old_b_e)
+						shiftEdge(t, h.edge(eId), old_b_e, new_b_e, h.edgeMultiplicity[eId], bad2);
+				}
+			} else
+				for (size_t j = 0; j < bad.size(); ++j)
+					if (b[at(bad[j], t)] != before[j])
+						topChanged.insert(bad[j]);
+			swap(bad, bad2);
+		}
+		publish();
+	}
+	// Apply updates of distinct edge IDs in a pipeline, with the same result as applying them one by one.
+	// Level t of an update reads level t - 1 and writes levels t and t + 1 only, so level t of update i can run
+	// at the same time as level t + 2 of update i - 1, level t + 4 of update i - 2 and so on: step s runs level s - 2i of every update i.
+	// All edges are inserted beforehand and deleted afterwards; windowPos hides each of them from the levels of the other updates that should not see it.
+	void applyPipelined(const vector<EdgeUpdate>& updates) {
+		if (updates.empty()) return;
+		for (const EdgeUpdate& update: updates)
+			if (update.updType == INS)
+				prepareInsertion(update.e);
+		for (const EdgeUpdate& update: updates)
+			if (update.updType == INS) {
+				h.insertEdge(update.e, update.eId);
+				finishInsertion(update.e);
+			}
+		if (h.edgeIdCounter > windowPos.size())
+			windowPos.resize(h.edgeIdCounter);
+		for (size_t i = 0; i < updates.size(); ++i)
+			windowPos[updates[i].eId] = updates[i].updType == INS ? (int)i + 1 : -(int)i - 1;
+		// Updates i and i + depth are never in flight at the same time, so they can share a pair of worklists
+		const size_t depth = tau / 2 + 1;
+		if (stageLists.size() < 2 * depth)
+			stageLists.resize(2 * depth);
+		vector<size_t> stages;
+		for (size_t s = 1; s <= 2 * (updates.size() - 1) + tau; ++s) {
+			stages.clear();
+			for (size_t i = s > (size_t)tau ? (s - tau + 1) / 2 : 0; 2 * i < s && i < updates.size(); ++i)
+				stages.push_back(i);
+			threads().parallelFor(stages.size(), [&](size_t k, unsigned) {
+				const size_t i = stages[k];
+				const unsigned t = s - 2 * i;
+				Worklist *lists = &stageLists[2 * (i % depth)];
+				if (updates[i].updType == INS)
+					insertionLevel(t, updates[i].e, updates[i].eId, i, lists[t & 1], lists[~t & 1]);
+				else
+					deletionLevel(t, updates[i].e, i, lists[t & 1], lists[~t & 1]);
+			});
+		}
+		for (const EdgeUpdate& update: updates) {
+			windowPos[update.eId] = 0;
+			if (update.updType == DEL)
+				h.deleteEdgeById(update.eId);
+		}
+		publish();
+	}
+	Hypergraph h;
+private:
+	double epsilon, lambda, alpha;
+	GraphScheduler scheduler;
+	size_t batchSize, pipelineSize;
+	ThreadPool *pool; // Created when first needed, see threads()
+
+	int tau;
+	typedef unsigned char LadderIndex;
+	// b[t][u] is Lambda[b[at(u, t)]]; sigma and rho use the same node-major layout, so all levels of a node are adjacent.
+	// The positions in Lambda are compared instead of the values they stand for, which preserves the order.
+	vector<unsigned> Lambda;
+	vector<LadderIndex> b;
+	vector<unsigned> sigma, rho;
+	// Position in Lambda of b_e at level t (1 <= t < tau), i.e. the minimum over the endpoints of edge eId, is edgeMin[eId * tau + t];
+	// edgeMinCount counts the endpoints that attain it, so most changes of b update b_e without visiting the endpoints.
+	vector<LadderIndex> edgeMin;
+	vector<unsigned> edgeMinCount;
+	Worklist bad, bad2; // Nodes to check at the current level and at the next one
+	Worklist changedEdges; // IDs of the edges whose b_e may have changed in a batch
+	CoreSnapshot snapshot; // Lambda[b[tau][u]] for the readers on other threads
+	Worklist topChanged; // Nodes whose b[tau] may have changed since the last publication to snapshot
+	// In applyPipelined(): i + 1 if the edge is inserted by update i of the window, -(i + 1) if it is deleted by update i, and 0 otherwise
+	vector<int> windowPos;
+	vector<Worklist> stageLists;
+	inline bool visible(unsigned eId, int view) const {
+		// Whether level scans of update view of the window see edge eId (view < 0 outside of a window)
+		if (view < 0) return true;
+		const int w = windowPos[eId];
+		return w == 0 || (w > 0 ? w <= view + 1 : view + 1 < -w);
+	}
+	// The edges of a node with at least HUB_DEGREE incident edges are scanned in parallel, in blocks of SCAN_BLOCK edges
+	static const size_t HUB_DEGREE = 1 << 15, SCAN_BLOCK = 1 << 12;
+	struct CounterDelta {
+		Node v;
+		int old_b_e, new_b_e;
+		unsigned m;
+	};
+	// Nodes with at least HISTOGRAM_DEGREE incident edges get a histogram: hist[u][t * Lambda.size() + x] is the number of edges of u
+	// (counting parallel copies) whose b_e at level t - 1 is at position x in Lambda, and b_e of level 1 is in topBucket().
+	// sigma and rho then follow a change of b in O(1) time instead of a scan of all edges of u.
+	static const size_t HISTOGRAM_DEGREE = 128;
+	vector<vector<unsigned>> hist;
+	inline int topBucket() const {
+		// Above every reachable b
+		return Lambda.size() - 1;
+	}
+	ThreadPool& threads() {
+		if (pool == NULL)
+			pool = new ThreadPool();
+		return *pool;
+	}
+	inline bool isHub(Node u) {
+		return h.eList[u].size() >= HUB_DEGREE && threads().size() > 1;
+	}
+	inline size_t at(Node u, unsigned t) const {
+		return (size_t)u * (tau + 1) + t;
+	}
+	void initialize() {
+		// alpha should be r * (1 + 3 * epsilon) where r is maximum edge cardinality.
+		// But we can slightly reduce it when r is too large.
+		// alpha is decided by input.
+
+		// alpha = 2 * (1 + 3 * epsilon);
+		// tau and the ladder grow with the number of nodes and the degrees (see addLevels() and growLadder()),
+		// so the statistics of the scheduler are only a head start and may be 0
+		tau = levelsFor(scheduler.numberOfNodes);
+		Lambda.assign(1, 0);
+		Lambda.push_back(1);
+		growLadder(0);
+		b.resize((size_t)scheduler.numberOfNodes * (tau + 1));
+		hist.resize(scheduler.numberOfNodes);
+		sigma.resize((size_t)scheduler.numberOfNodes * (tau + 1));
+		rho.resize((size_t)scheduler.numberOfNodes * (tau + 1));
+		cerr << "Lambda: ";
+		for (auto& lambda: Lambda) cerr << lambda << ' ';
+		cerr << endl;
+		cerr << "# of nodes = " << scheduler.numberOfNodes << endl;
+		cerr << "tau = " << tau << endl;
+		cerr << "max degree = " << scheduler.maxDegree << endl;
+	}
+	void insertEdge(const Hyperedge& e, unsigned eId) {
+	//	cerr << "Insert an edge" << endl;
+		prepareInsertion(e);
+		h.insertEdge(e, eId);
+		finishInsertion(e);
+		for (unsigned t = 1; t <= tau; ++t) {
+			insertionLevel(t, e, eId, -1, bad, bad2);
+			swap(bad, bad2);
+		}
+		publish();
+	}
+	// Level t of the insertion of edge eId: the nodes in bad are checked, and those to check at level t + 1 are put into bad2.
+	// view is the position of the update in the window of applyPipelined(), or -1.
+	void insertionLevel(unsigned t, const Hyperedge& e, unsigned eId, int view, Worklist& bad, Worklist& bad2) {
+		if (t == 1) {
+			bad.clear();
+			for (const Node u: e)
+				moveEdge(1, u, -1, topBucket(), 1, bad, NULL);
+		}
+		bad2.clear();
+		if (t < tau)
+			// b[t] has not changed since the edge appeared, so b_e is computed right before the promotions at level t
+			shiftEdge(t, h.edge(eId), -1, updateEdgeMin(t, eId), 1, bad2);
+		for (const Node u: bad)
+			if (sigma[at(u, t)] >= (unsigned)(alpha * Lambda[b[at(u, t)] + 1]))
+				promote(t, u, view, bad2);
+	}
+	void promote(const unsigned t, const Node u, int view, Worklist& bad2) {
+	//	cerr << "Promote " << t << ' ' << u << ' ' << newEdgeId << endl;
+		LadderIndex old_b_t_u = b[at(u, t)]++;
+		countersAfterPromotion(t, u, view);
+		if (t == tau) {
+			topChanged.insert(u);
+			return;
+		}
+		scanEdges(t, u, bad2, [&](size_t first, size_t last, vector<CounterDelta> *deltas) {
+			for (size_t j = first; j < last; ++j) {
+				const unsigned eId = h.eList[u][j];
+	//			cerr << "eId = " << eId << endl;
+				if (!visible(eId, view)) continue;
+				// b_e only grows if u was its only endpoint at the minimum
+				const size_t k = (size_t)eId * tau + t;
+				if (edgeMin[k] != old_b_t_u) continue;
+				if (edgeMinCount[k] > 1) {
+					--edgeMinCount[k];
+					continue;
+				}
+				const EdgeRange e = h.edge(eId);
+				const unsigned m = h.edgeMultiplicity[eId];
+				LadderIndex old_b_e = old_b_t_u, new_b_e = updateEdgeMin(t, eId);
+				for (const Node v: e)
+					moveEdge(t + 1, v, old_b_e, new_b_e, m, bad2, deltas);
+			}
+		});
+	//	cerr << "Promote finished." << endl;
+	}
+	void deleteEdge(const Hyperedge& e, unsigned eId) {
+	//	cerr << "Delete an edge" << endl;
+		h.deleteEdgeById(eId);
+		for (unsigned t = 1; t <= tau; ++t) {
+			deletionLevel(t, e, -1, bad, bad2);
+			swap(bad, bad2);
+		}
+		publish();
+	}
+	// Level t of the deletion of edge e (see insertionLevel())
+	void deletionLevel(unsigned t, const Hyperedge& e, int view, Worklist& bad, Worklist& bad2) {
+		if (t == 1) {
+			bad.clear();
+			for (const Node u: e)
+				moveEdge(1, u, topBucket(), -1, 1, bad, NULL);
+		}
+		bad2.clear();
+		if (t < tau) {
+			LadderIndex b_e = UCHAR_MAX;
+			for (const Node u: e)
+				b_e = min(b_e, b[at(u, t)]);
+			EdgeRange range = {e.data(), e.data() + e.size()};
+			shiftEdge(t, range, b_e, -1, 1, bad2);
+		}
+		for (const Node u: bad)
+			if (rho[at(u, t)] < Lambda[b[at(u, t)]])
+				demote(t, u, view, bad2);
+	}
+	void demote(const unsigned t, const Node u, int view, Worklist& bad2) {
+	//	cerr << "Demote " << t << ' ' << u << endl;
+		LadderIndex b_t_u = --b[at(u, t)];
+		countersAfterDemotion(t, u, view);
+		if (t == tau) {
+			topChanged.insert(u);
+			return;
+		}
+		scanEdges(t, u, bad2, [&](size_t first, size_t last, vector<CounterDelta> *deltas) {
+			for (size_t j = first; j < last; ++j) {
+				const unsigned eId = h.eList[u][j];
+				if (!visible(eId, view)) continue;
+				// b_e only drops if u drops below it
+				const size_t k = (size_t)eId * tau + t;
+				if (b_t_u > edgeMin[k]) continue;
+				if (b_t_u == edgeMin[k]) {
+					++edgeMinCount[k];
+					continue;
+				}
+				const EdgeRange e = h.edge(eId);
+				const unsigned m = h.edgeMultiplicity[eId];
+				LadderIndex old_b_e = edgeMin[k], new_b_e = b_t_u;
+				edgeMin[k] = new_b_e;
+				edgeMinCount[k] = 1;
+				for (const Node v: e)
+					moveEdge(t + 1, v, old_b_e, new_b_e, m, bad2, deltas);
+			}
+		});
+	}
+	template<class Scan> void scanEdges(unsigned t, Node u, Worklist& bad2, Scan scan) {
+		// scan(first, last, deltas) visits h.eList[u][first..last) and reports the changes of the counters of level t + 1 through moveEdge().
+		// Blocks of the edges of a hub are scanned in parallel, each collecting its changes, which are applied afterwards.
+		const size_t deg = h.eList[u].size();
+		if (!isHub(u)) {
+			scan(0, deg, NULL);
+			return;
+		}
+		vector<vector<CounterDelta>> deltas((deg + SCAN_BLOCK - 1) / SCAN_BLOCK);
+		threads().parallelFor(deltas.size(), [&](size_t k, unsigned) {
+			scan(k * SCAN_BLOCK, min(deg, (k + 1) * SCAN_BLOCK), &deltas[k]);
+		});
+		for (const auto& block: deltas)
+			for (const CounterDelta& d: block)
+				moveEdge(t + 1, d.v, d.old_b_e, d.new_b_e, d.m, bad2, NULL);
+	}
+	inline void moveEdge(unsigned t, Node v, int old_b_e, int new_b_e, unsigned m, Worklist& bad, vector<CounterDelta> *deltas) {
+		// Move m copies of an edge of v from b_e = old_b_e to new_b_e in the counters of v at level t (-1 stands for no edge).
+		// v has to be checked again if it may now be promoted or demoted, i.e. if sigma went up or rho went down.
+		if (deltas != NULL) {
+			CounterDelta d = {v, old_b_e, new_b_e, m};
+			deltas->push_back(d);
+			return;
+		}
+		const size_t i = at(v, t);
+		const int b_v = b[i], dSigma = (new_b_e > b_v) - (old_b_e > b_v), dRho = (new_b_e >= b_v) - (old_b_e >= b_v);
+		sigma[i] += dSigma * m;
+		rho[i] += dRho * m;
+		if (!hist[v].empty()) {
+			unsigned *buckets = &hist[v][t * Lambda.size()];
+			if (old_b_e >= 0) buckets[old_b_e] -= m;
+			if (new_b_e >= 0) buckets[new_b_e] += m;
+		}
+		if (dSigma > 0 || dRho < 0)
+			bad.insert(v);
+	}
+	void prepareInsertion(const Hyperedge& e) {
+		// Before edge e is inserted: add levels if its new nodes call for them, the nodes themselves and histograms for its endpoints
+		Node last = 0;
+		for (const Node u: e)
+			last = max(last, u);
+		if (at(last + 1, 0) > b.size()) {
+			addLevels(last + 1);
+			addNode(last);
+		}
+		addHistograms(e);
+	}
+	void finishInsertion(const Hyperedge& e) {
+		// After edge e is inserted
+		for (const Node u: e)
+			growLadder(h.degree[u]);
+		if ((size_t)h.edgeIdCounter * tau > edgeMin.size()) {
+			edgeMin.resize((size_t)h.edgeIdCounter * tau);
+			edgeMinCount.resize((size_t)h.edgeIdCounter * tau);
+		}
+	}
+	int levelsFor(unsigned n) const {
+		// tau for a hypergraph of n nodes
+		return max(1, (int)ceil(0.15 * log((double)max(n, 1u)) / log(1.0 + epsilon)));
+	}
+	void addLevels(unsigned n) {
+		// Levels only depend on the ones below, so the new top levels are computed from the current state, one after another:
+		// b starts from the level below and is settled node by node. No update has to be replayed.
+		const int oldTau = tau, newTau = levelsFor(n);
+		if (newTau <= oldTau) return;
+		const size_t nodes = b.size() / (oldTau + 1), H = Lambda.size();
+		vector<LadderIndex> newB(nodes * (newTau + 1));
+		vector<unsigned> newSigma(nodes * (newTau + 1)), newRho(nodes * (newTau + 1));
+		for (size_t u = 0; u < nodes; ++u)
+			for (int t = 0; t <= oldTau; ++t) {
+				newB[u * (newTau + 1) + t] = b[u * (oldTau + 1) + t];
+				newSigma[u * (newTau + 1) + t] = sigma[u * (oldTau + 1) + t];
+				newRho[u * (newTau + 1) + t] = rho[u * (oldTau + 1) + t];
+			}
+		b.swap(newB), sigma.swap(newSigma), rho.swap(newRho);
+		vector<LadderIndex> newEdgeMin((size_t)h.edgeIdCounter * newTau);
+		vector<unsigned> newEdgeMinCount((size_t)h.edgeIdCounter * newTau);
+		for (size_t eId = 0; eId < h.edgeIdCounter; ++eId)
+			for (int t = 1; t < oldTau; ++t) {
+				newEdgeMin[eId * newTau + t] = edgeMin[eId * oldTau + t];
+				newEdgeMinCount[eId * newTau + t] = edgeMinCount[eId * oldTau + t];
+			}
+		edgeMin.swap(newEdgeMin), edgeMinCount.swap(newEdgeMinCount);
+		for (auto& buckets: hist)
+			if (!buckets.empty())
+				buckets.resize((newTau + 1) * H);
+		tau = newTau;
+		for (int t = oldTau + 1; t <= tau; ++t) {
+			for (unsigned eId = 0; eId < h.edgeIdCounter; ++eId)
+				if (h.edgeMultiplicity[eId] > 0)
+					updateEdgeMin(t - 1, eId);
+			for (Node u = 0; u < hist.size(); ++u)
+				if (!hist[u].empty())
+					for (const unsigned eId: h.eList[u])
+						hist[u][t * H + edgeMin[(size_t)eId * tau + t - 1]] += h.edgeMultiplicity[eId];
+			// Nodes of a batch or window whose edges are not in h yet stay at 0
+			for (Node u = 0; u < nodes && u < h.eList.size(); ++u) {
+				b[at(u, t)] = b[at(u, t - 1)];
+				updateSigmaAndRho(t, u);
+				settle(t, u);
+			}
+		}
+		// Level tau is a new one
+		for (Node u = 0; u < nodes; ++u)
+			topChanged.insert(u);
+		cerr << "tau = " << tau << endl;
+	}
+	void growLadder(unsigned degree) {
+		// Keep the last value before the sentinel above every degree, so that b[t][u] + 1 is always a valid position.
+		// This builds the same ladder as knowing the maximum degree in advance would.
+		if (Lambda[Lambda.size() - 2] > degree) return;
+		const size_t oldH = Lambda.size();
+		while (Lambda[Lambda.size() - 2] <= degree)
+			Lambda.push_back(max((unsigned)(Lambda.back() * (1.0 + lambda)), Lambda.back() + 1));
+		if (Lambda.size() > UCHAR_MAX + 1) {
+			cerr << "lambda is too small: " << Lambda.size() << " values of b do not fit in one byte" << endl;
+			exit(1);
+		}
+		// Histograms are laid out by the length of the ladder, with the top bucket last
+		const size_t H = Lambda.size();
+		for (auto& buckets: hist) {
+			if (buckets.empty()) continue;
+			vector<unsigned> grown((tau + 1) * H);
+			for (int t = 0; t <= tau; ++t) {
+				copy(buckets.begin() + t * oldH, buckets.begin() + (t + 1) * oldH - 1, grown.begin() + t * H);
+				grown[t * H + H - 1] = buckets[t * oldH + oldH - 1];
+			}
+			buckets.swap(grown);
+		}
+	}
+	void publish() {
+		// At the end of an update, batch or window
+		if (topChanged.empty()) return;
+		snapshot.beginWrite();
+		for (const Node u: topChanged)
+			snapshot.set(u, Lambda[b[at(u, tau)]]);
+		snapshot.endWrite();
+		topChanged.clear();
+	}
+	void settle(unsigned t, Node u) {
+		// Move b[t][u] until u can be neither promoted nor demoted, without passing anything on to level t + 1
+		const size_t i = at(u, t);
+		while (true) {
+			if (sigma[i] >= (unsigned)(alpha * Lambda[b[i] + 1])) {
+				++b[i];
+				countersAfterPromotion(t, u, -1);
+			} else if (rho[i] < Lambda[b[i]]) {
+				--b[i];
+				countersAfterDemotion(t, u, -1);
+			} else
+				break;
+		}
+	}
+	void addNode(Node u) {
+		// Nodes the scheduler did not count (all of them without a prescan) are added on their first insertion
+		b.resize(at(u + 1, 0));
+		hist.resize(u + 1);
+		sigma.resize(at(u + 1, 0));
+		rho.resize(at(u + 1, 0));
+	}
+	LadderIndex updateEdgeMin(unsigned t, unsigned eId) {
+		// Recompute b_e at level t from the endpoints
+		const size_t k = (size_t)eId * tau + t;
+		edgeMin[k] = UCHAR_MAX;
+		edgeMinCount[k] = 0;
+		for (const Node v: h.edge(eId)) {
+			const LadderIndex b_t_v = b[at(v, t)];
+			if (b_t_v < edgeMin[k])
+				edgeMin[k] = b_t_v, edgeMinCount[k] = 1;
+			else if (b_t_v == edgeMin[k])
+				++edgeMinCount[k];
+		}
+		return edgeMin[k];
+	}
+	void shiftEdge(unsigned t, const EdgeRange& e, int old_b_e, int new_b_e, unsigned m, Worklist& bad2) {
+		// Move m copies of edge e from b_e = old_b_e to new_b_e at level t, i.e. in the counters of its endpoints at level t + 1
+		for (const Node v: e)
+			moveEdge(t + 1, v, old_b_e, new_b_e, m, bad2, NULL);
+	}
+	void countersAfterPromotion(unsigned t, Node u, int view) {
+		// The edges with b_e above the old b are those with b_e at least the new one
+		const size_t i = at(u, t);
+		if (hist[u].empty())
+			updateSigmaAndRho(t, u, view);
+		else
+			rho[i] = sigma[i], sigma[i] -= hist[u][t * Lambda.size() + b[i]];
+	}
+	void countersAfterDemotion(unsigned t, Node u, int view) {
+		// The edges with b_e at least the old b are those with b_e above the new one
+		const size_t i = at(u, t);
+		if (hist[u].empty())
+			updateSigmaAndRho(t, u, view);
+		else
+			sigma[i] = rho[i], rho[i] += hist[u][t * Lambda.size() + b[i]];
+	}
+	void addHistograms(const Hyperedge& e) {
+		// Called before edge e is inserted, so that its endpoints count it in their histograms once it reaches each level
+		for (const Node u: e) {
+			if (u >= hist.size() || !hist[u].empty() || u >= h.eList.size() || h.eList[u].size() < HISTOGRAM_DEGREE) continue;
+			const size_t H = Lambda.size();
+			hist[u].assign((tau + 1) * H, 0);
+			for (const unsigned eId: h.eList[u]) {
+				const unsigned m = h.edgeMultiplicity[eId];
+				hist[u][H + topBucket()] += m;
+				for (int t = 2; t <= tau; ++t)
+					hist[u][t * H + edgeMin[(size_t)eId * tau + t - 1]] += m;
+			}
+		}
+	}
+	void updateSigmaAndRho(unsigned t, Node u, int view = -1) {
+		const size_t i = at(u, t), deg = h.eList[u].size();
+		if (!isHub(u)) {
+			countSigmaAndRho(t, u, view, 0, deg, sigma[i], rho[i]);
+			return;
+		}
+		vector<pair<unsigned, unsigned>> partial((deg + SCAN_BLOCK - 1) / SCAN_BLOCK);
+		threads().parallelFor(partial.size(), [&](size_t k, unsigned) {
+			countSigmaAndRho(t, u, view, k * SCAN_BLOCK, min(deg, (k + 1) * SCAN_BLOCK), partial[k].first, partial[k].second);
+		});
+		sigma[i] = rho[i] = 0;
+		for (const auto& p: partial)
+			sigma[i] += p.first, rho[i] += p.second;
+	}
+	void countSigmaAndRho(unsigned t, Node u, int view, size_t first, size_t last, unsigned& s, unsigned& r) {
+		// sigma and rho of u at level t, restricted to h.eList[u][first..last)
+		const LadderIndex b_t_u = b[at(u, t)];
+		s = r = 0;
+		for (size_t j = first; j < last; ++j) {
+			const unsigned eId = h.eList[u][j];
+			if (!visible(eId, view)) continue;
+			const unsigned m = h.edgeMultiplicity[eId];
+			// At level 1, b_e is considered infinite
+			if (t == 1 || edgeMin[(size_t)eId * tau + t - 1] > b_t_u) s += m, r += m;
+			else if (edgeMin[(size_t)eId * tau + t - 1] == b_t_u) r += m;
+		}
+	}
+};
+
+int main(int argc, char **argv) {
+	double epsilon = atof(argv[1]);
+	double lambda = atof(argv[2]);
+	double alpha = atof(argv[3]);
+	char *fileName = argv[4];
+	const char *batchSize = GraphScheduler::option(argc, argv, 5, "batch"), *pipelineSize = GraphScheduler::option(argc, argv, 5, "pipeline");
+	FullyDynamic fullyDynamic(epsilon, lambda, alpha, fileName, GraphScheduler::parseFlags(argc, argv, 5),
+		batchSize == NULL ? 0 : atoi(batchSize), pipelineSize == NULL ? 0 : atoi(pipelineSize), GraphScheduler::option(argc, argv, 5, "restore"));
+	const char *reportEvery = GraphScheduler::option(argc, argv, 5, "report"), *reportInterval = GraphScheduler::option(argc, argv, 5, "interval");
+	time_t t = clock();
+	fullyDynamic.run(reportEvery == NULL ? 100000 : atoi(reportEvery), reportInterval == NULL ? 0 : atof(reportInterval),
+		GraphScheduler::option(argc, argv, 5, "values"), GraphScheduler::option(argc, argv, 5, "checkpoint"));
+	t = clock() - t;
+	FILE *ofp = fopen("StatTimeMemory.txt", "a");
+	fprintf(ofp, "Round\t%.2f\t%f\t", epsilon, t / 1000.0);
+	cerr << t << " ms." << endl;
+//	fullyDynamic.debug();
+//	Node u;
+//	while (cin >> u)
+//		cout << fullyDynamic.getApproxCoreVal(u) << endl;
+	fullyDynamic.debug();
+	cerr << "Finished!!!" << endl;
+	double mem = outputMemory();
+	fprintf(ofp, "%f\n", mem);
+	fclose(ofp);
+	return 0;
+}
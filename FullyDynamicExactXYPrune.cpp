@@ -1,275 +1,302 @@
-/*
-The fully dynamic algorithm of Li et al. ("Efficient Core Maintenance in Large Dynamic Graphs", TKDE 2014) generalized to hypergraphs.
-
-[To compile]
-g++ -std=c++11 -O3 FullyDynamicExactXYPrune.cpp GraphScheduler.cpp Hypergraph.cpp HypergraphCoreDecomp.cpp -Wl,--stack=167772160 -o FullyDynamicExactXYPrune -lpsapi
-
-[To run]
-FullyDynamicExactXYPrune filename
-
-[Format of input]
-The file should contain an update in each line.
-Hyperedge insertion: + [node IDs] timestamp
-Hyperedge deletion: - [node IDs]
-So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
-The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
-When deleting a hyperedge, make sure that exactly the same sequence appeared in an insertion update before.
-Therefore, it is recommended that in each line, the node IDs are sorted in some particular order, e.g., increasing order.
-
-[Remark]
-"-Wl,--stack=167772160" is used to set stack size. (Note that this program has a DFS.)
-This program is developed on Windows. "-lpsapi" is related to reporting memory usage. You may have to remove it and "OutputMemory.cpp" (which includes a function outputMemory()) and reimplement this part when you want to compile and run the code on a different operating system.
-*/
-
-#include <cstdio>
-#include <ctime>
-#include <cassert>
-#include <iostream>
-#include <unordered_map>
-#include "Hypergraph.hpp"
-#include "GraphScheduler.hpp"
-#include "HypergraphCoreDecomp.hpp"
-#include "OutputMemory.cpp"
-using namespace std;
-
-class FullyDynamic {
-public:
-	FullyDynamic(char fileName[]): scheduler(fileName) {}
-    void run() {
-    	FILE *ofpTime = fopen("StatFullyDynamicExactTime.txt", "a");
-    	FILE *ofpMem = fopen("StatTimeMemory.txt", "a");
-    	unsigned cnt = 0;
-    	time_t t0 = clock();
-    	while (scheduler.hasNext()) {
-			EdgeUpdate edgeUpdate = scheduler.nextUpdate();
-			if (edgeUpdate.updType == INS)
-				insertEdge(edgeUpdate.e);
-			else
-				deleteEdge(edgeUpdate.e);
-			++cnt;
-			if (cnt % 100000 == 0) {
-				fprintf(stderr, "%d...\t", cnt);
-				time_t t1 = clock();
-				fprintf(ofpTime, "%d\n", t1 - t0);
-				fflush(ofpTime);
-				t0 = t1;
-				fprintf(ofpMem, "%f MB.\n", outputMemory());
-				fflush(ofpMem);
-				// Verify correctness
-			//	HypergraphCoreDecomp hcd(h);
-			//	hcd.solve();
-			//	for (auto &p: c) {
-			//		Node u = p.first;
-			//		assert(hcd.c[u] == c[u]);
-			//	}
-			}
-		//	for (auto& p: hcd.c) {
-		//		printf("%d %d\n", p.first, p.second);
-		//	}
-		//	printf("---\n");
-    	}
-    	fclose(ofpTime);
-    	fclose(ofpMem);
-    }
-    Hypergraph h;
-private:
-	GraphScheduler scheduler;
-	unordered_map<Node, unsigned> c;
-	unordered_set<Node> candidates;
-	unordered_set<Node> demotedNodes;
-	unordered_set<unsigned> visited; // IDs of visited hyperedges
-	unsigned newEdgeId;
-	void insertEdge(const Hyperedge& e) {
-		newEdgeId = h.insertEdge(e);
-		visited.clear();
-		candidates.clear();
-		unsigned val = INT_MAX;
-		for (const Node u: e)
-			val = min(val, c[u]);
-		for (const Node u: e)
-			if (c[u] == val)
-				XYPruneColorInsert(u, val);
-		recolorInsert(val);
-		for (const Node u: candidates)
-			++c[u];
-	}
-	void deleteEdge(const Hyperedge& e) { // Algorithm 9
-		h.deleteEdge(e);
-		visited.clear();
-		candidates.clear();
-		demotedNodes.clear();
-		unsigned val = INT_MAX;
-		for (const Node u: e)
-			val = min(val, c[u]);
-		for (const Node u: e) {
-			if (c[u] == val) {
-				// Compute X_u (line 4 of Algorithm 9)
-				unsigned x = 0;
-				for (const unsigned eId: h.eList[u]) {
-					const Hyperedge &e = h.edgePool[eId];
-					bool ok = true;
-					for (const Node w: e) {
-						if (c[w] < val) {
-							ok = false;
-							break;
-						}
-					}
-					if (ok) ++x;
-				}
-				if (x < val) // Line 8, 14, 20, 30 and 34 of Algorithm 9
-					YPruneColorDelete(u, val);
-			}
-		}
-		recolorDelete(val);
-		for (const Node u: demotedNodes)
-			--c[u];
-	}
-	/*void color(Node u, unsigned val) {
-		candidates.insert(u);
-		for (const unsigned eId: h.eList[u]) {
-			if (visited.count(eId)) continue;
-			visited.insert(eId);
-			const Hyperedge &e = h.edgePool[eId];
-			unsigned b = INT_MAX;
-			for (const Node w: e)
-				b = min(b, c[w]);
-			if (b < val) continue;
-			for (const Node w: e)
-				if (!candidates.count(w) && c[w] == val)
-					color(w, val);
-		}
-	}*/
-	void XYPruneColorInsert(Node u, unsigned val) {
-		unsigned x = 0, y = 0;
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge &e = h.edgePool[eId];
-			unsigned b = INT_MAX;
-			for (const Node w: e)
-				if (w != u)
-					b = min(b, c[w]);
-			if (b >= val) ++x;
-			if (b > val && eId != newEdgeId) ++y;
-		}
-		if (x > val) {
-			candidates.insert(u); // Line 14 - 16 of Algorithm 11
-			if (y < val) { // It seems that the condition c = 0 in line 10 of Algorithm 11 is unnecessary
-				for (const unsigned eId: h.eList[u]) {
-					if (visited.count(eId)) continue;
-					visited.insert(eId);
-					const Hyperedge &e = h.edgePool[eId];
-					bool ok = true;
-					for (const Node w: e) {
-						if (c[w] < val) {
-							ok = false;
-							break;
-						}
-					}
-					if (!ok) continue;
-					for (const Node w: e)
-						if (!candidates.count(w) && c[w] == val)
-							XYPruneColorInsert(w, val);
-				}
-			}
-		}
-	}
-	void YPruneColorDelete(Node u, unsigned val) { // Algorithm 10
-		candidates.insert(u);
-		unsigned y = 0;
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge &e = h.edgePool[eId];
-			bool ok = true;
-			for (const Node w: e) {
-				if (w != u && c[w] <= val) {
-					ok = false;
-					break;
-				}
-			}
-			if (ok) ++y;
-		}
-		if (y < val) {
-			for (const unsigned eId: h.eList[u]) {
-				if (visited.count(eId)) continue;
-				visited.insert(eId);
-				const Hyperedge &e = h.edgePool[eId];
-				bool ok = true;
-				for (const Node w: e) {
-					if (c[w] < val) {
-						ok = false;
-						break;
-					}
-				}
-				if (!ok) continue;
-				for (const Node w: e)
-					if (!candidates.count(w) && c[w] == val)
-						YPruneColorDelete(w, val);
-			}
-		}
-	}
-	void recolorInsert(unsigned val) {
-		for (bool flag = true; flag;) {
-			flag = false;
-			auto iter = candidates.begin();
-			while (iter != candidates.end()) {
-				const Node u = *iter;
-				unsigned x = 0;
-				for (const unsigned eId: h.eList[u]) {
-					const Hyperedge &e = h.edgePool[eId];
-					bool ok = true;
-					for (const Node v: e) { // Check whether hyperedge e can count towards x
-						if (c[v] + candidates.count(v) <= val) {
-							ok = false;
-							break;
-						}
-					}
-					if (ok) ++x;
-				}
-				if (x <= val) {
-					iter = candidates.erase(iter);
-					flag = true;
-				} else {
-					++iter;
-				}
-			}
-		}
-	}
-	void recolorDelete(unsigned val) {
-		for (bool flag = true; flag;) {
-			flag = false;
-			auto iter = candidates.begin();
-			while (iter != candidates.end()) {
-				const Node u = *iter;
-				unsigned x = 0;
-				for (const unsigned eId: h.eList[u]) {
-					const Hyperedge &e = h.edgePool[eId];
-					bool ok = true;
-					for (const Node v: e) {
-						if (c[v] + candidates.count(v) <= val) {
-							ok = false;
-							break;
-						}
-					}
-					if (ok) ++x;
-				}
-				if (x < val) {
-					demotedNodes.insert(u);
-					iter = candidates.erase(iter);
-					flag = true;
-				} else {
-					++iter;
-				}
-			}
-		}
-	}
-};
-
-int main(int argc, char **argv) {
-	char *fileName = argv[1];
-	FullyDynamic fullyDynamic(fileName);
-	time_t t0 = clock();
-	fullyDynamic.run();
-	FILE *ofp = fopen("StatTimeMemory.txt", "a");
-	fprintf(ofp, "%d ms.\n", clock() - t0);
-	fprintf(ofp, "%f MB.\n", outputMemory());
-	fclose(ofp);
-	return 0;
-}
+/*
+The fully dynamic algorithm of Li et al. ("Efficient Core Maintenance in Large Dynamic Graphs", TKDE 2014) generalized to hypergraphs.
+
+[To compile]
+g++ -std=c++11 -O3 FullyDynamicExactXYPrune.cpp GraphScheduler.cpp Hypergraph.cpp HypergraphCoreDecomp.cpp -pthread -o FullyDynamicExactXYPrune -lpsapi
+
+[To run]
+FullyDynamicExactXYPrune filename [stream] [collapse] [threads=number]
+With threads=number, large frontiers of the coloring are examined by that many threads.
+
+[Format of input]
+The file should contain an update in each line.
+Hyperedge insertion: + [node IDs] timestamp
+Hyperedge deletion: - [node IDs]
+So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
+The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
+When deleting a hyperedge, make sure that exactly the same sequence appeared in an insertion update before.
+Therefore, it is recommended that in each line, the node IDs are sorted in some particular order, e.g., increasing order.
+
+[Remark]
+This program is developed on Windows. "-lpsapi" is related to reporting memory usage. You may have to remove it and "OutputMemory.cpp" (which includes a function outputMemory()) and reimplement this part when you want to compile and run the code on a different operating system.
+*/
+
+#include <cstdio>
+#include <ctime>
+#include <cassert>
+#include <iostream>
+#include <unordered_map>
+#include "Hypergraph.hpp"
+#include "GraphScheduler.hpp"
+#include "HypergraphCoreDecomp.hpp"
+#include "Worklist.hpp"
+#include "ThreadPool.hpp"
+#include "OutputMemory.cpp"
+using namespace std;
+
+class FullyDynamic {
+public:
+	// With threads > 1, frontiers of at least PARALLEL_FRONTIER nodes are examined in parallel (see probe())
+	FullyDynamic(char fileName[], unsigned schedulerFlags = 0, unsigned threads = 1):
+		scheduler(fileName, schedulerFlags | DENSE_IDS | EDGE_IDS), c(scheduler.numberOfNodes), pool(threads > 1 ? new ThreadPool(threads) : NULL) {}
+	~FullyDynamic() {
+		delete pool;
+	}
+    void run() {
+    	FILE *ofpTime = fopen("StatFullyDynamicExactTime.txt", "a");
+    	FILE *ofpMem = fopen("StatTimeMemory.txt", "a");
+    	unsigned cnt = 0;
+    	time_t t0 = clock();
+    	while (scheduler.hasNext()) {
+			const EdgeUpdate& edgeUpdate = scheduler.nextUpdate();
+			if (edgeUpdate.updType == INS)
+				insertEdge(edgeUpdate.e, edgeUpdate.eId);
+			else
+				deleteEdge(edgeUpdate.e, edgeUpdate.eId);
+			++cnt;
+			if (cnt % 100000 == 0) {
+				fprintf(stderr, "%d...\t", cnt);
+				time_t t1 = clock();
+				fprintf(ofpTime, "%d\n", t1 - t0);
+				fflush(ofpTime);
+				t0 = t1;
+				fprintf(ofpMem, "%f MB.\n", outputMemory());
+				fflush(ofpMem);
+				// Verify correctness
+			//	HypergraphCoreDecomp hcd(h);
+			//	hcd.solve();
+			//	for (Node u = 0; u < c.size(); ++u)
+			//		assert(hcd.c[u] == c[u]);
+			}
+		//	for (auto& p: hcd.c) {
+		//		printf("%d %d\n", p.first, p.second);
+		//	}
+		//	printf("---\n");
+    	}
+    	fclose(ofpTime);
+    	fclose(ofpMem);
+    }
+    Hypergraph h;
+private:
+	GraphScheduler scheduler;
+	vector<unsigned> c; // Indexed by (dense) node ID
+	unordered_set<Node> candidates;
+	unordered_set<Node> demotedNodes;
+	// The coloring goes through the graph a frontier at a time instead of by recursion, so its depth is not limited by the stack.
+	// The nodes it reaches, and which of them are colored, do not depend on the order in which they are examined.
+	Worklist visited; // IDs of visited hyperedges
+	Worklist queued; // Nodes that have been in a frontier
+	vector<Node> frontier, next;
+	vector<unsigned> xs, ys; // x and y of the nodes of the frontier
+	ThreadPool *pool;
+	static const size_t PARALLEL_FRONTIER = 1024;
+	unsigned newEdgeId;
+	void insertEdge(const Hyperedge& e, unsigned eId) {
+		newEdgeId = h.insertEdge(e, eId);
+		if (h.eList.size() > c.size())
+			c.resize(h.eList.size());
+		visited.clear();
+		queued.clear();
+		candidates.clear();
+		unsigned val = INT_MAX;
+		for (const Node u: e)
+			val = min(val, c[u]);
+		frontier.clear();
+		for (const Node u: e)
+			if (c[u] == val && queued.insert(u))
+				frontier.push_back(u);
+		colorInsert(val);
+		recolorInsert(val);
+		for (const Node u: candidates)
+			++c[u];
+	}
+	void deleteEdge(const Hyperedge& e, unsigned eId) { // Algorithm 9
+		h.deleteEdgeById(eId);
+		visited.clear();
+		queued.clear();
+		candidates.clear();
+		demotedNodes.clear();
+		frontier.clear();
+		unsigned val = INT_MAX;
+		for (const Node u: e)
+			val = min(val, c[u]);
+		for (const Node u: e) {
+			if (c[u] == val) {
+				// Compute X_u (line 4 of Algorithm 9)
+				unsigned x = 0;
+				for (const unsigned eId: h.eList[u]) {
+					const EdgeRange e = h.edge(eId);
+					bool ok = true;
+					for (const Node w: e) {
+						if (c[w] < val) {
+							ok = false;
+							break;
+						}
+					}
+					if (ok) x += h.edgeMultiplicity[eId];
+				}
+				if (x < val && queued.insert(u)) // Line 8, 14, 20, 30 and 34 of Algorithm 9
+					frontier.push_back(u);
+			}
+		}
+		colorDelete(val);
+		recolorDelete(val);
+		for (const Node u: demotedNodes)
+			--c[u];
+	}
+	/*void color(Node u, unsigned val) {
+		candidates.insert(u);
+		for (const unsigned eId: h.eList[u]) {
+			if (visited.count(eId)) continue;
+			visited.insert(eId);
+			const EdgeRange e = h.edge(eId);
+			unsigned b = INT_MAX;
+			for (const Node w: e)
+				b = min(b, c[w]);
+			if (b < val) continue;
+			for (const Node w: e)
+				if (!candidates.count(w) && c[w] == val)
+					color(w, val);
+		}
+	}*/
+	void colorInsert(unsigned val) { // XYPruneColorInsert (Algorithm 11) from the nodes in frontier
+		while (!frontier.empty()) {
+			probe(val, true);
+			next.clear();
+			for (size_t k = 0; k < frontier.size(); ++k) {
+				if (xs[k] > val) {
+					candidates.insert(frontier[k]); // Line 14 - 16 of Algorithm 11
+					if (ys[k] < val) // It seems that the condition c = 0 in line 10 of Algorithm 11 is unnecessary
+						expand(frontier[k], val);
+				}
+			}
+			frontier.swap(next);
+		}
+	}
+	void colorDelete(unsigned val) { // YPruneColorDelete (Algorithm 10) from the nodes in frontier
+		while (!frontier.empty()) {
+			probe(val, false);
+			next.clear();
+			for (size_t k = 0; k < frontier.size(); ++k) {
+				candidates.insert(frontier[k]);
+				if (ys[k] < val)
+					expand(frontier[k], val);
+			}
+			frontier.swap(next);
+		}
+	}
+	void probe(unsigned val, bool insertion) {
+		// Compute x and y of every node of the frontier, which only reads c and h
+		xs.resize(frontier.size());
+		ys.resize(frontier.size());
+		auto examine = [&](size_t k, unsigned) {
+			const Node u = frontier[k];
+			unsigned x = 0, y = 0;
+			for (const unsigned eId: h.eList[u]) {
+				const EdgeRange e = h.edge(eId);
+				unsigned b = INT_MAX;
+				for (const Node w: e)
+					if (w != u)
+						b = min(b, c[w]);
+				if (insertion) {
+					if (b >= val) x += h.edgeMultiplicity[eId];
+					if (b > val) y += h.edgeMultiplicity[eId] - (eId == newEdgeId); // Other than the new copy
+				} else if (b > val) {
+					y += h.edgeMultiplicity[eId];
+				}
+			}
+			xs[k] = x, ys[k] = y;
+		};
+		if (pool != NULL && frontier.size() >= PARALLEL_FRONTIER)
+			pool->parallelFor(frontier.size(), examine, 64);
+		else
+			for (size_t k = 0; k < frontier.size(); ++k)
+				examine(k, 0);
+	}
+	void expand(Node u, unsigned val) {
+		// Queue the nodes of value val on the unvisited edges of u whose nodes all have values of at least val
+		for (const unsigned eId: h.eList[u]) {
+			if (!visited.insert(eId)) continue;
+			const EdgeRange e = h.edge(eId);
+			bool ok = true;
+			for (const Node w: e) {
+				if (c[w] < val) {
+					ok = false;
+					break;
+				}
+			}
+			if (!ok) continue;
+			for (const Node w: e)
+				if (c[w] == val && queued.insert(w))
+					next.push_back(w);
+		}
+	}
+	void recolorInsert(unsigned val) {
+		for (bool flag = true; flag;) {
+			flag = false;
+			auto iter = candidates.begin();
+			while (iter != candidates.end()) {
+				const Node u = *iter;
+				unsigned x = 0;
+				for (const unsigned eId: h.eList[u]) {
+					const EdgeRange e = h.edge(eId);
+					bool ok = true;
+					for (const Node v: e) { // Check whether hyperedge e can count towards x
+						if (c[v] + candidates.count(v) <= val) {
+							ok = false;
+							break;
+						}
+					}
+					if (ok) x += h.edgeMultiplicity[eId];
+				}
+				if (x <= val) {
+					iter = candidates.erase(iter);
+					flag = true;
+				} else {
+					++iter;
+				}
+			}
+		}
+	}
+	void recolorDelete(unsigned val) {
+		for (bool flag = true; flag;) {
+			flag = false;
+			auto iter = candidates.begin();
+			while (iter != candidates.end()) {
+				const Node u = *iter;
+				unsigned x = 0;
+				for (const unsigned eId: h.eList[u]) {
+					const EdgeRange e = h.edge(eId);
+					bool ok = true;
+					for (const Node v: e) {
+						if (c[v] + candidates.count(v) <= val) {
+							ok = false;
+							break;
+						}
+					}
+					if (ok) x += h.edgeMultiplicity[eId];
+				}
+				if (x < val) {
+					demotedNodes.insert(u);
+					iter = candidates.erase(iter);
+					flag = true;
+				} else {
+					++iter;
+				}
+			}
+		}
+	}
+};
+
+int main(int argc, char **argv) {
+	char *fileName = argv[1];
+	const char *threads = GraphScheduler::option(argc, argv, 2, "threads");
+	FullyDynamic fullyDynamic(fileName, GraphScheduler::parseFlags(argc, argv, 2), threads == NULL ? 1 : atoi(threads));
+	time_t t0 = clock();
+	fullyDynamic.run();
+	FILE *ofp = fopen("StatTimeMemory.txt", "a");
+	fprintf(ofp, "%d ms.\n", clock() - t0);
+	fprintf(ofp, "%f MB.\n", outputMemory());
+	fclose(ofp);
+	return 0;
+}
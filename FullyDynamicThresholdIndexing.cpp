@@ -1,219 +1,365 @@
-/*
-A fully dynamic hypergraph approximate k-core maintenance algorithm, which is equivalent to our (round-indexing) fully dynamic algorithm but uses the threshold-indexing approach.
-
-[To compile]
-g++ -std=c++11 -O3 FullyDynamicThresholdIndexing.cpp GraphScheduler.cpp Hypergraph.cpp -o FullyDynamicThresholdIndexing -lpsapi
-
-[To run]
-FullyDynamicThresholdIndexing epsilon lambda alpha filename
-
-[Format of input]
-The file should contain an update in each line.
-Hyperedge insertion: + [node IDs] timestamp
-Hyperedge deletion: - [node IDs]
-So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
-The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
-When deleting a hyperedge, make sure that exactly the same sequence appeared in an insertion update before.
-Therefore, it is recommended that in each line, the node IDs are sorted in some particular order, e.g., increasing order.
-
-[Remark]
-This program is developed on Windows. "-lpsapi" is related to reporting memory usage. You may have to remove it and "OutputMemory.cpp" (which includes a function outputMemory()) and reimplement this part when you want to compile and run the code on a different operating system.
-*/
-
-#include <cmath>
-#include <ctime>
-#include <iostream>
-#include <unordered_set>
-#include "Hypergraph.hpp"
-#include "GraphScheduler.hpp"
-#include "OutputMemory.cpp"
-using namespace std;
-
-class FullyDynamic {
-public:
-	FullyDynamic(double epsilon, double lambda, double alpha, char fileName[]):
-		epsilon(epsilon), lambda(lambda), alpha(alpha), scheduler(fileName) {
-			initialize();
-	}
-	void run() {
-		int cnt = 0;
-		while (scheduler.hasNext()) {
-			EdgeUpdate edgeUpdate = scheduler.nextUpdate();
-			if (edgeUpdate.updType == INS)
-				insertEdge(edgeUpdate.e);
-			else
-				deleteEdge(edgeUpdate.e);
-			++cnt;
-			if (cnt % 100000 == 0) {
-				cerr << cnt << "...\t";
-			}
-		}
-		cerr << thresholds.size() << "thresholds. Max threshold = " << thresholds.back() << "." << endl;
-	}
-	unsigned getApproxCoreVal(Node u) {
-		int p = 0, q = thresholds.size();
-		while (p + 1 < q) {
-			int m = (p + q) >> 1;
-			if (l[m][u] < tau)
-				q = m;
-			else
-				p = m;
-		}
-		return thresholds[p];
-	}
-	void debug() {
-		for (int i = 1; i <= 100; ++i)
-			cerr << getApproxCoreVal(i) << ' ';
-		cerr << endl;
-	}
-private:
-	double epsilon, lambda, alpha;
-	GraphScheduler scheduler;
-	Hypergraph h;
-	int tau;
-	vector<unordered_map<Node, int>> l, b, a;
-	vector<unsigned> thresholds;
-	const bool DYNAMIC_THRESHOLDS = true;
-	void initialize() {
-		tau = ceil(0.15 * log(scheduler.numberOfNodes) / log(1.0 + epsilon));
-		thresholds.push_back(0);
-		if (!DYNAMIC_THRESHOLDS)
-			while (thresholds.back() < scheduler.maxDegree)
-				thresholds.push_back(max((unsigned)(thresholds.back() * (1.0 + lambda)), thresholds.back() + 1));
-		l.resize(thresholds.size());
-		b.resize(thresholds.size());
-		a.resize(thresholds.size());
-	}
-	void insertEdge(const Hyperedge& e) {
-		h.insertEdge(e);
-		unordered_set<Node> bad;
-		int originalSize = thresholds.size();
-		for (int i = 0; i < thresholds.size(); ++i) {
-			unsigned beta = thresholds[i];
-			if (i < originalSize) {
-				int l_e = INT_MAX;
-				for (const Node u: e)
-					l_e = min(l_e, l[i][u]);
-				for (const Node u: e) {
-					if (l_e >= l[i][u]) ++b[i][u], bad.insert(u);
-					if (l_e >= l[i][u] - 1) ++a[i][u];
-				}
-			}
-			else {
-				for (auto& p: h.eList) {
-					const Node u = p.first;
-					b[i][u] = p.second.size();
-					bad.insert(u);
-				}
-			}
-			while (!bad.empty()) {
-				const Node u = *bad.begin();
-				if (l[i][u] < tau && b[i][u] >= (unsigned)(alpha * beta)) {
-					promote(i, u, bad);
-					if (DYNAMIC_THRESHOLDS)
-						if (i == thresholds.size() - 1 && l[i][u] == tau) {
-							thresholds.push_back(max((unsigned)(thresholds.back() * (1.0 + lambda)), thresholds.back() + 1));
-							l.resize(thresholds.size());
-							b.resize(thresholds.size());
-							a.resize(thresholds.size());
-						}
-				}
-				else
-					bad.erase(u);
-			}
-		}
-	}
-	void promote(const unsigned i, const Node u, unordered_set<Node>& bad) {
-		int old_l_u = l[i][u];
-		++l[i][u];
-		updateBAndA(i, u);
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge& e = h.edgePool[eId];
-			int old_l_e = INT_MAX;
-			for (const Node v: e)
-				if (v != u)
-					old_l_e = min(old_l_e, l[i][v]);
-			int new_l_e = min(old_l_e, l[i][u]);
-			old_l_e = min(old_l_e, old_l_u);
-			if (new_l_e == old_l_e) continue;
-			for (const Node v: e) {
-				if (old_l_e < l[i][v] && l[i][v] <= new_l_e)
-					++b[i][v], bad.insert(v);
-				if (old_l_e < l[i][v] - 1 && l[i][v] - 1 <= new_l_e)
-					++a[i][v];
-			}
-		}
-	}
-	void deleteEdge(const Hyperedge& e) {
-		h.deleteEdge(e);
-		unordered_set<Node> bad;
-		for (int i = 0; i < thresholds.size(); ++i) {
-			unsigned beta = thresholds[i];
-			int l_e = INT_MAX;
-			for (const Node u: e)
-				l_e = min(l_e, l[i][u]);
-			for (const Node u: e) {
-				if (l_e >= l[i][u]) --b[i][u];
-				if (l_e >= l[i][u] - 1) --a[i][u], bad.insert(u);
-			}
-			while (!bad.empty()) {
-				const Node u = *bad.begin();
-				if (l[i][u] > 0 && a[i][u] < beta)
-					demote(i, u, bad);
-				else
-					bad.erase(u);
-			}
-		}
-	}
-	void demote(const unsigned i, const Node u, unordered_set<Node>& bad) {
-		int old_l_u = l[i][u];
-		--l[i][u];
-		updateBAndA(i, u);
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge& e = h.edgePool[eId];
-			int old_l_e = INT_MAX;
-			for (const Node v: e)
-				if (v != u)
-					old_l_e = min(old_l_e, l[i][v]);
-			int new_l_e = min(old_l_e, l[i][u]);
-			old_l_e = min(old_l_e, old_l_u);
-			if (new_l_e == old_l_e) continue;
-			for (const Node v: e) {
-				if (new_l_e < l[i][v] && l[i][v] <= old_l_e)
-					--b[i][v];
-				if (new_l_e < l[i][v] - 1 && l[i][v] - 1 <= old_l_e)
-					--a[i][v], bad.insert(v);
-			}
-		}
-	}
-	void updateBAndA(unsigned i, Node u) {
-		b[i][u] = a[i][u] = 0;
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge& e = h.edgePool[eId];
-			int l_e = INT_MAX;
-			for (const Node v: e)
-				l_e = min(l_e, l[i][v]);
-			if (l_e >= l[i][u]) ++b[i][u];
-			if (l_e >= l[i][u] - 1) ++a[i][u];
-		}
-	}
-};
-
-int main(int argc, char** argv) {
-	double epsilon = atof(argv[1]);
-	double lambda = atof(argv[2]);
-	double alpha = atof(argv[3]);
-	char* fileName = argv[4];
-	FullyDynamic fullyDynamic(epsilon, lambda, alpha, fileName);
-	time_t t = clock();
-	fullyDynamic.run();
-	t = clock() - t;
-	FILE *ofp = fopen("StatTimeMemory.txt", "a");
-	fprintf(ofp, "Thres\t%.2f\t%f\t", epsilon, t / 1000.0);
-	cerr << t << " ms." << endl;
-	fullyDynamic.debug();
-	double mem = outputMemory();
-	fprintf(ofp, "%f\n", mem);
-	fclose(ofp);
-	return 0;
-}
+/*
+A fully dynamic hypergraph approximate k-core maintenance algorithm, which is equivalent to our (round-indexing) fully dynamic algorithm but uses the threshold-indexing approach.
+
+[To compile]
+g++ -std=c++11 -O3 FullyDynamicThresholdIndexing.cpp GraphScheduler.cpp Hypergraph.cpp -pthread -o FullyDynamicThresholdIndexing -lpsapi
+
+[To run]
+FullyDynamicThresholdIndexing epsilon lambda alpha filename [stream] [collapse] [values=filename]
+With values=filename, the approximate core values of all nodes are written to that file at the end, a line "node value" for each positive one.
+
+[Format of input]
+The file should contain an update in each line.
+Hyperedge insertion: + [node IDs] timestamp
+Hyperedge deletion: - [node IDs]
+So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
+The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
+When deleting a hyperedge, make sure that exactly the same sequence appeared in an insertion update before.
+Therefore, it is recommended that in each line, the node IDs are sorted in some particular order, e.g., increasing order.
+
+[Remark]
+This program is developed on Windows. "-lpsapi" is related to reporting memory usage. You may have to remove it and "OutputMemory.cpp" (which includes a function outputMemory()) and reimplement this part when you want to compile and run the code on a different operating system.
+*/
+
+#include <cmath>
+#include <ctime>
+#include <climits>
+#include <iostream>
+#include <unordered_set>
+#include "Hypergraph.hpp"
+#include "GraphScheduler.hpp"
+#include "Worklist.hpp"
+#include "ThreadPool.hpp"
+#include "OutputMemory.cpp"
+using namespace std;
+
+class FullyDynamic {
+public:
+	FullyDynamic(double epsilon, double lambda, double alpha, char fileName[], unsigned schedulerFlags = 0):
+		epsilon(epsilon), lambda(lambda), alpha(alpha), scheduler(fileName, schedulerFlags | DENSE_IDS | EDGE_IDS), workers(pool.size()) {
+			initialize();
+	}
+	void run() {
+		int cnt = 0;
+		while (scheduler.hasNext()) {
+			const EdgeUpdate& edgeUpdate = scheduler.nextUpdate();
+			if (edgeUpdate.updType == INS)
+				insertEdge(edgeUpdate.e, edgeUpdate.eId);
+			else
+				deleteEdge(edgeUpdate.e, edgeUpdate.eId);
+			++cnt;
+			if (cnt % 100000 == 0) {
+				cerr << cnt << "...\t";
+			}
+		}
+		cerr << thresholds.size() << "thresholds. Max threshold = " << thresholds.back() << "." << endl;
+	}
+	unsigned getApproxCoreVal(Node u) {
+		// u is a node ID of the input
+		if (!scheduler.denseId(u, u) || u >= top.size())
+			return 0;
+		return thresholds[top[u]];
+	}
+	// Write a line "node value" for every node with a positive approximate core value
+	void writeCoreValues(const char *fileName) {
+		FILE *ofp = fopen(fileName, "w");
+		if (ofp == NULL) return;
+		for (Node u = 0; u < top.size(); ++u)
+			if (thresholds[top[u]] > 0)
+				fprintf(ofp, "%u %u\n", scheduler.originalId(u), thresholds[top[u]]);
+		fclose(ofp);
+	}
+	void debug() {
+		for (int i = 1; i <= 100; ++i)
+			cerr << getApproxCoreVal(i) << ' ';
+		cerr << endl;
+	}
+private:
+	double epsilon, lambda, alpha;
+	GraphScheduler scheduler;
+	Hypergraph h;
+	int tau;
+	// Levels are at most tau, so they take a byte each. Every threshold has its own array (indexed by dense node ID),
+	// so the workers that update different thresholds do not write to the same cache lines.
+	typedef unsigned char Level;
+	vector<vector<Level>> l;
+	// Indexed by threshold and then by (dense) node ID. At level 0, every edge counts for b, so b is the degree and is read from h
+	// (see support()), and a is not used; neither is kept up to date there, which lets an update skip the thresholds
+	// at which all its endpoints are at level 0 and cannot leave it (see affected()).
+	vector<vector<int>> b, a;
+	// top[u] is the index of the threshold that getApproxCoreVal() reports for u: the largest one at which u is at level tau (or 0).
+	// It only changes when u reaches or leaves level tau somewhere.
+	vector<unsigned> top;
+	// reach[u] is one more than the largest threshold at which u is above level 0 (0 if there is none), so that an update
+	// can stop looking for affected thresholds there (see affected()). It only changes when u reaches or leaves level 0 somewhere.
+	vector<unsigned> reach;
+	// With DYNAMIC_THRESHOLDS, the nodes that may move at a threshold added next. At level 0, b is the degree, so a node whose degree
+	// is below alpha * thresholds.back() stays at level 0 of the largest threshold and of any larger one.
+	// Nodes join when an insertion lifts their degree and leave (lazily) when a threshold is added.
+	vector<Node> heavy;
+	vector<bool> isHeavy;
+	// The thresholds only share h, which does not change while they are updated, so every update is handed to all of them
+	// in parallel and they are joined before the next one
+	ThreadPool pool;
+	struct Worker {
+		Worklist bad; // Nodes whose level may have to change
+		Worklist moved; // Nodes that reached or left level 0 or tau, whose top and reach are refreshed after the join
+	};
+	vector<Worker> workers; // One for each thread of the pool
+	vector<unsigned> thresholds;
+	vector<unsigned> active; // The thresholds an update is handed to
+	const bool DYNAMIC_THRESHOLDS = true;
+	void initialize() {
+		tau = ceil(0.15 * log(scheduler.numberOfNodes) / log(1.0 + epsilon));
+		if (tau > UCHAR_MAX) {
+			cerr << "epsilon is too small: tau = " << tau << " levels do not fit in one byte" << endl;
+			exit(1);
+		}
+		thresholds.push_back(0);
+		if (!DYNAMIC_THRESHOLDS)
+			while (thresholds.back() < scheduler.maxDegree)
+				thresholds.push_back(max((unsigned)(thresholds.back() * (1.0 + lambda)), thresholds.back() + 1));
+		addThresholds();
+	}
+	inline int level(unsigned i, Node u) const {
+		return l[i][u];
+	}
+	inline unsigned support(unsigned i, Node u) const {
+		return level(i, u) == 0 ? h.degree[u] : b[i][u];
+	}
+	void affected(const Hyperedge& e, bool insertion) {
+		// Collect in active the thresholds where an endpoint of e is above level 0 or, for an insertion, may be promoted from there.
+		// The bounds alpha * beta grow with the threshold, so an insertion affects every threshold up to the first bound above
+		// the largest degree of an endpoint. Beyond that, only the thresholds below the reach of an endpoint are looked at.
+		active.clear();
+		if (insertion) {
+			unsigned heaviest = 0;
+			for (const Node u: e)
+				heaviest = max(heaviest, h.degree[u]);
+			while (active.size() < thresholds.size() && heaviest >= (unsigned)(alpha * thresholds[active.size()]))
+				active.push_back(active.size());
+		}
+		unsigned end = 0;
+		for (const Node u: e)
+			end = max(end, reach[u]);
+		for (unsigned i = active.size(); i < end; ++i) {
+			bool hit = false;
+			for (auto iter = e.begin(); !hit && iter != e.end(); ++iter)
+				hit = level(i, *iter) > 0;
+			if (hit)
+				active.push_back(i);
+		}
+	}
+	void addThresholds() {
+		// Give every threshold without state one entry per node
+		size_t n = l.empty() ? scheduler.numberOfNodes : top.size();
+		l.resize(thresholds.size(), vector<Level>(n));
+		b.resize(thresholds.size(), vector<int>(n));
+		a.resize(thresholds.size(), vector<int>(n));
+		top.resize(n);
+		reach.resize(n);
+		isHeavy.resize(n);
+	}
+	void addNode(Node u) {
+		// Only needed if the scheduler reported fewer nodes than the updates contain
+		top.resize(u + 1);
+		reach.resize(u + 1);
+		isHeavy.resize(u + 1);
+		for (size_t i = 0; i < thresholds.size(); ++i) {
+			l[i].resize(u + 1);
+			b[i].resize(u + 1);
+			a[i].resize(u + 1);
+		}
+	}
+	void refresh(Node u) {
+		top[u] = reach[u] = 0;
+		for (unsigned i = thresholds.size(); i-- > 0;) {
+			if (reach[u] == 0 && level(i, u) > 0)
+				reach[u] = i + 1;
+			if (level(i, u) == tau) {
+				top[u] = i;
+				break;
+			}
+		}
+	}
+	void refreshMoved() {
+		// After the join
+		for (Worker& worker: workers) {
+			for (const Node u: worker.moved)
+				refresh(u);
+			worker.moved.clear();
+		}
+	}
+	void insertEdge(const Hyperedge& e, unsigned eId) {
+		h.insertEdge(e, eId);
+		for (const Node u: e)
+			if (u >= top.size())
+				addNode(u);
+		if (DYNAMIC_THRESHOLDS)
+			for (const Node u: e)
+				if (!isHeavy[u] && h.degree[u] >= (unsigned)(alpha * thresholds.back()))
+					isHeavy[u] = true, heavy.push_back(u);
+		const size_t last = thresholds.size() - 1;
+		bool grow = false;
+		affected(e, true);
+		pool.parallelFor(active.size(), [&](size_t k, unsigned w) {
+			const unsigned i = active[k];
+			Worker& worker = workers[w];
+			Worklist& bad = worker.bad;
+			bad.clear();
+			int l_e = INT_MAX;
+			for (const Node u: e)
+				l_e = min(l_e, level(i, u));
+			for (const Node u: e) {
+				if (l_e >= level(i, u)) ++b[i][u], bad.insert(u);
+				if (l_e >= level(i, u) - 1) ++a[i][u];
+			}
+			if (promoteAll(i, worker) && i == last)
+				grow = true;
+		});
+		refreshMoved();
+		// A node reaching the top level of the largest threshold needs the next one (which may need another one).
+		// The other thresholds do not depend on it, so it can wait until they are done.
+		while (DYNAMIC_THRESHOLDS && grow) {
+			thresholds.push_back(max((unsigned)(thresholds.back() * (1.0 + lambda)), thresholds.back() + 1));
+			addThresholds();
+			// Every node starts at level 0, where b is the degree, and only the heavy ones can be promoted from there.
+			// Promoting them settles the new threshold without visiting the rest of the graph.
+			const unsigned i = thresholds.size() - 1, bound = alpha * thresholds[i];
+			Worklist& bad = workers[0].bad;
+			bad.clear();
+			size_t k = 0;
+			for (const Node u: heavy)
+				if (h.degree[u] >= bound)
+					heavy[k++] = u, bad.insert(u);
+				else
+					isHeavy[u] = false;
+			heavy.resize(k);
+			grow = promoteAll(i, workers[0]);
+			refreshMoved();
+		}
+	}
+	bool promoteAll(const unsigned i, Worker& worker) {
+		// Promote the nodes in worker.bad at threshold i, and those whose b grows on the way, as far as they go.
+		// Returns whether a node reached the top level.
+		const unsigned beta = thresholds[i];
+		Worklist& bad = worker.bad;
+		bool reached = false;
+		while (!bad.empty()) {
+			const Node u = bad.pop();
+			while (level(i, u) < tau && support(i, u) >= (unsigned)(alpha * beta)) {
+				promote(i, u, worker);
+				if (level(i, u) == tau)
+					reached = true;
+			}
+		}
+		return reached;
+	}
+	void promote(const unsigned i, const Node u, Worker& worker) {
+		Worklist& bad = worker.bad;
+		int old_l_u = level(i, u);
+		if (++l[i][u] == tau || old_l_u == 0)
+			worker.moved.insert(u);
+		updateBAndA(i, u);
+		for (const unsigned eId: h.eList[u]) {
+			const EdgeRange e = h.edge(eId);
+			const unsigned m = h.edgeMultiplicity[eId];
+			int old_l_e = INT_MAX;
+			for (const Node v: e)
+				if (v != u)
+					old_l_e = min(old_l_e, level(i, v));
+			int new_l_e = min(old_l_e, level(i, u));
+			old_l_e = min(old_l_e, old_l_u);
+			if (new_l_e == old_l_e) continue;
+			for (const Node v: e) {
+				if (old_l_e < level(i, v) && level(i, v) <= new_l_e)
+					b[i][v] += m, bad.insert(v);
+				if (old_l_e < level(i, v) - 1 && level(i, v) - 1 <= new_l_e)
+					a[i][v] += m;
+			}
+		}
+	}
+	void deleteEdge(const Hyperedge& e, unsigned eId) {
+		h.deleteEdgeById(eId);
+		// Nothing moves where all endpoints are at level 0
+		affected(e, false);
+		pool.parallelFor(active.size(), [&](size_t k, unsigned w) {
+			const unsigned i = active[k];
+			Worker& worker = workers[w];
+			Worklist& bad = worker.bad;
+			bad.clear();
+			const unsigned beta = thresholds[i];
+			int l_e = INT_MAX;
+			for (const Node u: e)
+				l_e = min(l_e, level(i, u));
+			for (const Node u: e) {
+				if (l_e >= level(i, u)) --b[i][u];
+				if (l_e >= level(i, u) - 1) --a[i][u], bad.insert(u);
+			}
+			while (!bad.empty()) {
+				const Node u = bad.pop();
+				while (level(i, u) > 0 && a[i][u] < (int)beta)
+					demote(i, u, worker);
+			}
+		});
+		refreshMoved();
+	}
+	void demote(const unsigned i, const Node u, Worker& worker) {
+		Worklist& bad = worker.bad;
+		int old_l_u = level(i, u);
+		if (l[i][u]-- == tau || old_l_u == 1)
+			worker.moved.insert(u);
+		updateBAndA(i, u);
+		for (const unsigned eId: h.eList[u]) {
+			const EdgeRange e = h.edge(eId);
+			const unsigned m = h.edgeMultiplicity[eId];
+			int old_l_e = INT_MAX;
+			for (const Node v: e)
+				if (v != u)
+					old_l_e = min(old_l_e, level(i, v));
+			int new_l_e = min(old_l_e, level(i, u));
+			old_l_e = min(old_l_e, old_l_u);
+			if (new_l_e == old_l_e) continue;
+			for (const Node v: e) {
+				if (new_l_e < level(i, v) && level(i, v) <= old_l_e)
+					b[i][v] -= m;
+				if (new_l_e < level(i, v) - 1 && level(i, v) - 1 <= old_l_e)
+					a[i][v] -= m, bad.insert(v);
+			}
+		}
+	}
+	void updateBAndA(unsigned i, Node u) {
+		b[i][u] = a[i][u] = 0;
+		for (const unsigned eId: h.eList[u]) {
+			const EdgeRange e = h.edge(eId);
+			const unsigned m = h.edgeMultiplicity[eId];
+			int l_e = INT_MAX;
+			for (const Node v: e)
+				l_e = min(l_e, level(i, v));
+			if (l_e >= level(i, u)) b[i][u] += m;
+			if (l_e >= level(i, u) - 1) a[i][u] += m;
+		}
+	}
+};
+
+int main(int argc, char** argv) {
+	double epsilon = atof(argv[1]);
+	double lambda = atof(argv[2]);
+	double alpha = atof(argv[3]);
+	char* fileName = argv[4];
+	FullyDynamic fullyDynamic(epsilon, lambda, alpha, fileName, GraphScheduler::parseFlags(argc, argv, 5));
+	time_t t = clock();
+	fullyDynamic.run();
+	t = clock() - t;
+	const char *valuesFile = GraphScheduler::option(argc, argv, 5, "values");
+	if (valuesFile != NULL)
+		fullyDynamic.writeCoreValues(valuesFile);
+	FILE *ofp = fopen("StatTimeMemory.txt", "a");
+	fprintf(ofp, "Thres\t%.2f\t%f\t", epsilon, t / 1000.0);
+	cerr << t << " ms." << endl;
+	fullyDynamic.debug();
+	double mem = outputMemory();
+	fprintf(ofp, "%f\n", mem);
+	fclose(ofp);
+	return 0;
+}
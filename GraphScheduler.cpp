@@ -1,77 +1,644 @@
-#include "GraphScheduler.hpp"
-#include <cassert>
-#include <string>
-#include <iostream>
-#include <algorithm>
-#include <unordered_map>
-using namespace std;
-
-GraphScheduler::GraphScheduler(const char fileName[]) {
-	fin.open(fileName);
-	load();
-	fin.close();
-	position = 0;
-}
-
-void GraphScheduler::load() {
-	string delimiter = " ";
-	string line;
-	vector<string> tokens;
-	unordered_map<unsigned, unsigned> deg;
-	maxDegree = 0;
-
-	while (getline(fin, line)) {
-		tokens.clear();
-		size_t pos = 0;
-		std::string token;
-		while (pos != line.npos) {
-			pos = line.find(delimiter);
-			token = line.substr(0, pos);
-			tokens.push_back(token);
-			line.erase(0, pos + delimiter.length());
-		}
-
-		assert(tokens.size() >= 2);
-
-		EdgeUpdate edgeUpdate;
-		if (tokens[0][0] == '+') {
-			edgeUpdate.updType = INS;
-		} else if (tokens[0][0] == '-') {
-			edgeUpdate.updType = DEL;
-		} else {
-			assert(false);
-		}
-
-		for (size_t i = 1; i < tokens.size(); i++)
-			edgeUpdate.e.push_back(atoi(tokens[i].c_str()));
-		if (edgeUpdate.updType == INS) {
-			edgeUpdate.timestamp = edgeUpdate.e.back();
-			edgeUpdate.e.pop_back();
-        }
-		sort(edgeUpdate.e.begin(), edgeUpdate.e.end());
-		edgeUpdate.e.shrink_to_fit();
-
-		if (edgeUpdate.updType == INS)
-			for (auto& u: edgeUpdate.e) {
-				++deg[u];
-				maxDegree = max(maxDegree, deg[u]);
-			}
-		updates.push_back(edgeUpdate);
-
-		const int MOD = 1000000; // 100000000
-		if (updates.size() % MOD == MOD - 1) {
-			cerr << "READ #: " << updates.size() + 1 << endl;
-		}
-	}
-
-	// Only in C++11
-	updates.shrink_to_fit();
-	//edge_queue_no_time_.shrink_to_fit();
-
-	numberOfNodes = deg.size();
-	cerr << "Finished. " << updates.size() << " updates." << endl;
-}
-
-EdgeUpdate GraphScheduler::nextUpdate() {
-	return updates[position++];
-}
+#include "GraphScheduler.hpp"
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include "ThreadPool.hpp"
+#include "BinaryFormat.hpp"
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+using namespace std;
+
+// Unbuffered reads of a live input, which return whatever the writer has sent so far
+static int openInput(const char fileName[]) {
+	if (!strcmp(fileName, "-"))
+		return 0;
+#ifdef _WIN32
+	return _open(fileName, _O_RDONLY | _O_BINARY);
+#else
+	return open(fileName, O_RDONLY);
+#endif
+}
+
+static int readInput(int fd, char *p, size_t n) {
+	int bytes;
+#ifdef _WIN32
+	while ((bytes = _read(fd, p, (unsigned)n)) < 0 && errno == EINTR);
+#else
+	while ((bytes = read(fd, p, n)) < 0 && errno == EINTR);
+#endif
+	return bytes;
+}
+
+static void closeInput(int fd) {
+#ifdef _WIN32
+	_close(fd);
+#else
+	close(fd);
+#endif
+}
+
+static inline unsigned partition(Node u, unsigned nParts) {
+	return (unsigned)(((unsigned long long)(u * 2654435761u) * nParts) >> 32);
+}
+
+GraphScheduler::GraphScheduler(const char fileName[], unsigned flags):
+	input(isLive(fileName) ? openInput(fileName) : -1), file(input >= 0 ? "" : fileName),
+	flags(flags), cursor(NULL), lastTimestamp(0), position(0), idPosition(0), first(0), startOffset(0), lastOffset(0), offsetPosition(0),
+	offsetCursor(NULL), lastInsertion(0), hashedBytes(0), hashValue(0), buffer(NULL), current(NULL), held(NULL) {
+	if (input >= 0) {
+		// Nothing is known about a live input in advance
+		this->flags |= STREAMING;
+		numberOfUpdates = numberOfNodes = maxDegree = maxCardinality = 0;
+		binary = false;
+	} else {
+		if (!file.ok()) {
+			cerr << "Cannot read " << fileName << endl;
+			exit(1);
+		}
+		BinaryHeader header;
+		binary = decodeHeader(file.data(), file.size(), header);
+		if (!binary && file.size() >= 4 && memcmp(file.data(), BINARY_MAGIC, 4) == 0) {
+			cerr << fileName << " is truncated within its header" << endl;
+			exit(1);
+		}
+		if (binary) {
+			// The statistics are in the header, so there is nothing to load
+			if (header.version != BINARY_VERSION) {
+				cerr << fileName << " has unsupported binary format version " << header.version << endl;
+				exit(1);
+			}
+			// Every update takes at least a byte
+			if (header.numberOfUpdates > file.size() - BINARY_HEADER_SIZE) {
+				cerr << fileName << " is truncated: its header announces " << header.numberOfUpdates << " updates in "
+					<< file.size() - BINARY_HEADER_SIZE << " bytes" << endl;
+				exit(1);
+			}
+			numberOfUpdates = header.numberOfUpdates;
+			numberOfNodes = header.numberOfNodes;
+			maxDegree = header.maxDegree;
+			maxCardinality = header.maxCardinality;
+			cursor = file.data() + BINARY_HEADER_SIZE;
+			cerr << "Binary log. " << numberOfUpdates << " updates." << endl;
+		}
+	}
+	if (!(flags & DEFERRED))
+		start();
+}
+
+void GraphScheduler::start(size_t offset, size_t updates, int lastTimestamp, const vector<Node> *originalIds, const Hypergraph *h) {
+	first = updates;
+	lastInsertion = lastTimestamp;
+	if (originalIds != NULL) {
+		toDense.reserve(originalIds->size());
+		toOriginal = *originalIds;
+		for (Node u = 0; u < toOriginal.size(); ++u)
+			toDense[toOriginal[u]] = u;
+	}
+	if (h != NULL && (flags & EDGE_IDS))
+		restoreEdges(*h);
+	if (input >= 0) {
+		// The bytes before offset are not sent again, so they only count towards offset()
+		startOffset = offset;
+		buffer = new RingBuffer<EdgeUpdate>(STREAM_BUFFER_SIZE);
+		if (flags & NO_PRESCAN)
+			producer = thread(&GraphScheduler::produceLive, this);
+		else {
+			cerr << "This algorithm needs the statistics of the whole log and cannot read a live input" << endl;
+			exit(1);
+		}
+	} else if (binary) {
+		if (updates > 0) {
+			cursor = file.data() + min(offset, file.size());
+			this->lastTimestamp = lastTimestamp;
+			numberOfUpdates -= min(updates, numberOfUpdates);
+		}
+		startOffset = cursor - file.data();
+		if (flags & DENSE_IDS)
+			toDense.reserve(numberOfNodes);
+		if (flags & STREAMING) {
+			buffer = new RingBuffer<EdgeUpdate>(STREAM_BUFFER_SIZE);
+			producer = thread(&GraphScheduler::produce, this);
+		}
+	} else if (flags & STREAMING) {
+		startOffset = min(offset, file.size());
+		// Most engines size their data structures from the statistics, so collect them first;
+		// this pass keeps only per-node counters, not the updates themselves.
+		if (flags & NO_PRESCAN)
+			numberOfUpdates = numberOfNodes = maxDegree = maxCardinality = 0;
+		else
+			scanStats();
+		if (flags & DENSE_IDS)
+			toDense.reserve(numberOfNodes);
+		buffer = new RingBuffer<EdgeUpdate>(STREAM_BUFFER_SIZE);
+		producer = thread(&GraphScheduler::produce, this);
+	} else {
+		startOffset = min(offset, file.size());
+		load();
+	}
+	lastOffset = startOffset;
+	offsetCursor = file.data() == NULL ? NULL : file.data() + startOffset;
+}
+
+GraphScheduler::~GraphScheduler() {
+	if (buffer != NULL) {
+		buffer->close();
+		if (producer.joinable())
+			producer.join();
+		delete buffer;
+	}
+	if (input > 0)
+		closeInput(input);
+}
+
+bool GraphScheduler::isLive(const char fileName[]) {
+	if (!strcmp(fileName, "-"))
+		return true;
+#ifdef _WIN32
+	return false;
+#else
+	struct stat st;
+	return stat(fileName, &st) == 0 && (S_ISFIFO(st.st_mode) || S_ISCHR(st.st_mode));
+#endif
+}
+
+size_t GraphScheduler::queued() const {
+	if (!(flags & STREAMING))
+		return numberOfUpdates - position;
+	// The slot of the update handed out last is only returned to the producer by the next call to hasNext()
+	return buffer->size() - (held != NULL ? 1 : 0);
+}
+
+unsigned GraphScheduler::parseFlags(int argc, char **argv, int first) {
+	unsigned flags = 0;
+	for (int i = first; i < argc; ++i) {
+		if (!strcmp(argv[i], "stream"))
+			flags |= STREAMING;
+		else if (!strcmp(argv[i], "collapse"))
+			flags |= COLLAPSE_PARALLEL;
+		else if (strchr(argv[i], '=') == NULL)
+			cerr << "Unknown option " << argv[i] << endl;
+	}
+	return flags;
+}
+
+const char *GraphScheduler::option(int argc, char **argv, int first, const char *name) {
+	size_t len = strlen(name);
+	for (int i = first; i < argc; ++i)
+		if (!strncmp(argv[i], name, len) && argv[i][len] == '=')
+			return argv[i] + len + 1;
+	return NULL;
+}
+
+const char *GraphScheduler::parseUpdate(const char *p, const char *end, Update& updType, int& timestamp, vector<Node>& ids) {
+	// Skip blank lines
+	while (p < end && (*p == '\n' || *p == '\r' || *p == ' ' || *p == '\t'))
+		++p;
+	if (p == end)
+		return NULL;
+	if (*p == '+') {
+		updType = INS;
+	} else if (*p == '-') {
+		updType = DEL;
+	} else {
+		assert(false);
+	}
+	++p;
+	size_t first = ids.size();
+	while (true) {
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+			++p;
+		if (p == end || *p == '\n')
+			break;
+		bool negative = (*p == '-');
+		if (negative) ++p;
+		unsigned x = 0;
+		while (p < end && (unsigned)(*p - '0') < 10)
+			x = x * 10 + (*p++ - '0');
+		// Like atoi, ignore anything after the digits of a token
+		while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+			++p;
+		ids.push_back(negative ? 0u - x : x);
+	}
+
+	assert(ids.size() > first);
+
+	if (updType == INS) {
+		timestamp = (int)ids.back();
+		ids.pop_back();
+	}
+	sort(ids.begin() + first, ids.end());
+	return p;
+}
+
+void GraphScheduler::parseChunks(vector<Chunk>& chunks, bool keepUpdates) {
+	// Parse the file on all cores and merge the per-chunk degree counts into numberOfNodes and maxDegree
+	ThreadPool pool;
+	const unsigned nParts = pool.size();
+	const char *data = file.data() == NULL ? NULL : file.data() + startOffset;
+	size_t size = file.size() - startOffset, nChunks = data == NULL ? 0 : 4 * pool.size();
+	chunks.resize(nChunks);
+	for (size_t c = 0; c < nChunks; ++c) {
+		// Each chunk begins right after the first line break at or after its nominal offset
+		const char *p = data + size / nChunks * c;
+		if (c > 0)
+			while (p < data + size && *(p - 1) != '\n')
+				++p;
+		chunks[c].begin = p;
+		if (c > 0)
+			chunks[c - 1].end = p;
+	}
+	if (nChunks > 0)
+		chunks.back().end = data + size;
+
+	pool.parallelFor(nChunks, [&](size_t c, unsigned) {
+		Chunk& chunk = chunks[c];
+		chunk.endpoints.resize(nParts);
+		chunk.deg.resize(nParts);
+		chunk.nUpdates = chunk.maxCardinality = 0;
+		const char *p = chunk.begin;
+		Update updType;
+		int timestamp = 0;
+		while (p != NULL) {
+			size_t start = chunk.ids.size();
+			if ((p = parseUpdate(p, chunk.end, updType, timestamp, chunk.ids)) == NULL)
+				break;
+			if (updType == INS)
+				for (size_t i = start; i < chunk.ids.size(); ++i) {
+					unsigned part = partition(chunk.ids[i], nParts);
+					chunk.endpoints[part].push_back(chunk.ids[i]);
+					if (!keepUpdates && chunk.endpoints[part].size() == FOLD_SIZE) {
+						// Without the updates in memory, keep the memory for counting bounded by the number of nodes
+						for (const Node u: chunk.endpoints[part])
+							++chunk.deg[part][u];
+						chunk.endpoints[part].clear();
+					}
+				}
+			++chunk.nUpdates;
+			chunk.maxCardinality = max(chunk.maxCardinality, (unsigned)(chunk.ids.size() - start));
+			if (keepUpdates) {
+				chunk.types.push_back(updType);
+				chunk.cardinalities.push_back(chunk.ids.size() - start);
+				chunk.timestamps.push_back(updType == INS ? timestamp : 0);
+			} else
+				chunk.ids.clear();
+		}
+	});
+
+	// Every partition of nodes is counted by one thread: sorting its endpoints groups the occurrences of each node
+	vector<unsigned> partNodes(nParts), partMaxDegree(nParts);
+	pool.parallelFor(nParts, [&](size_t part, unsigned) {
+		vector<Node> endpoints;
+		unordered_map<Node, unsigned> deg;
+		for (auto& chunk: chunks) {
+			endpoints.insert(endpoints.end(), chunk.endpoints[part].begin(), chunk.endpoints[part].end());
+			vector<Node>().swap(chunk.endpoints[part]);
+			for (auto& p: chunk.deg[part])
+				deg[p.first] += p.second;
+			unordered_map<Node, unsigned>().swap(chunk.deg[part]);
+		}
+		sort(endpoints.begin(), endpoints.end());
+		for (size_t i = 0, j; i < endpoints.size(); i = j) {
+			for (j = i + 1; j < endpoints.size() && endpoints[j] == endpoints[i]; ++j);
+			if (deg.empty()) {
+				++partNodes[part];
+				partMaxDegree[part] = max(partMaxDegree[part], (unsigned)(j - i));
+			} else
+				deg[endpoints[i]] += j - i;
+		}
+		if (!deg.empty()) {
+			partNodes[part] = deg.size();
+			for (auto& p: deg)
+				partMaxDegree[part] = max(partMaxDegree[part], p.second);
+		}
+	});
+	numberOfNodes = maxDegree = maxCardinality = 0;
+	for (unsigned part = 0; part < nParts; ++part) {
+		numberOfNodes += partNodes[part];
+		maxDegree = max(maxDegree, partMaxDegree[part]);
+	}
+	numberOfUpdates = 0;
+	for (auto& chunk: chunks) {
+		numberOfUpdates += chunk.nUpdates;
+		maxCardinality = max(maxCardinality, chunk.maxCardinality);
+	}
+}
+
+void GraphScheduler::remap(Node *begin, Node *end) {
+	// Only the thread producing the updates modifies the maps, so it can look them up without locking
+	for (Node *p = begin; p != end; ++p) {
+		auto iter = toDense.find(*p);
+		if (iter == toDense.end()) {
+			lock_guard<mutex> lock(idMutex);
+			iter = toDense.insert(make_pair(*p, (Node)toOriginal.size())).first;
+			toOriginal.push_back(*p);
+		}
+		*p = iter->second;
+	}
+	sort(begin, end);
+}
+
+bool GraphScheduler::denseId(Node original, Node& dense) {
+	lock_guard<mutex> lock(idMutex);
+	auto iter = toDense.find(original);
+	if (iter == toDense.end())
+		return false;
+	dense = iter->second;
+	return true;
+}
+
+Node GraphScheduler::originalId(Node dense) {
+	lock_guard<mutex> lock(idMutex);
+	return toOriginal[dense];
+}
+
+unsigned GraphScheduler::resolve(Update updType, const Node *begin, const Node *end) {
+	key.assign(begin, end);
+	if (updType == INS) {
+		vector<unsigned>& copies = liveEdges[key];
+		unsigned eId = (flags & COLLAPSE_PARALLEL) && !copies.empty() ? copies.back() : edgeIds.acquire();
+		copies.push_back(eId);
+		return eId;
+	}
+	// Of several parallel edges, the one inserted last is deleted first
+	auto iter = liveEdges.find(key);
+	assert(iter != liveEdges.end());
+	unsigned eId = iter->second.back();
+	iter->second.pop_back();
+	// The ID is free for insertions after this deletion, unless it is shared by other copies
+	if (!(flags & COLLAPSE_PARALLEL) || iter->second.empty())
+		edgeIds.release(eId);
+	if (iter->second.empty())
+		liveEdges.erase(iter);
+	return eId;
+}
+
+static const char *checked(const char *p) {
+	// p is the end of a varint or NULL (see getVarint())
+	if (p == NULL) {
+		cerr << "The binary log is truncated or corrupt" << endl;
+		exit(1);
+	}
+	return p;
+}
+
+void GraphScheduler::decodeUpdate(const char *&p, const char *end, int& lastTimestamp, EdgeUpdate& edgeUpdate) {
+	unsigned x, cardinality;
+	p = checked(getVarint(p, end, x));
+	edgeUpdate.updType = (x & 1) ? DEL : INS;
+	cardinality = x >> 1;
+	// Each endpoint takes at least a byte
+	if (cardinality > (size_t)(end - p))
+		checked(NULL);
+	edgeUpdate.e.resize(cardinality);
+	Node u = 0;
+	for (unsigned i = 0; i < cardinality; ++i) {
+		p = checked(getVarint(p, end, x));
+		edgeUpdate.e[i] = u += x;
+	}
+	if (edgeUpdate.updType == INS) {
+		p = checked(getVarint(p, end, x));
+		edgeUpdate.timestamp = lastTimestamp = (int)((unsigned)lastTimestamp + (unsigned)unzigzag(x));
+	}
+}
+
+void GraphScheduler::load() {
+	vector<Chunk> chunks;
+	parseChunks(chunks, true);
+
+	// Splice the chunks back together in their original order
+	size_t nIds = 0, nUpdates = 0;
+	vector<size_t> idOffset, updateOffset;
+	for (auto& chunk: chunks) {
+		idOffset.push_back(nIds);
+		updateOffset.push_back(nUpdates);
+		nIds += chunk.ids.size();
+		nUpdates += chunk.types.size();
+	}
+	ids.resize(nIds);
+	cardinalities.resize(nUpdates);
+	timestamps.resize(nUpdates);
+	types.resize(nUpdates);
+	ThreadPool pool;
+	pool.parallelFor(chunks.size(), [&](size_t c, unsigned) {
+		Chunk& chunk = chunks[c];
+		copy(chunk.ids.begin(), chunk.ids.end(), ids.begin() + idOffset[c]);
+		copy(chunk.cardinalities.begin(), chunk.cardinalities.end(), cardinalities.begin() + updateOffset[c]);
+		copy(chunk.timestamps.begin(), chunk.timestamps.end(), timestamps.begin() + updateOffset[c]);
+		copy(chunk.types.begin(), chunk.types.end(), types.begin() + updateOffset[c]);
+		chunk = Chunk();
+	});
+
+	if (flags & DENSE_IDS)
+		toDense.reserve(numberOfNodes);
+	if (flags & (DENSE_IDS | EDGE_IDS)) {
+		if (flags & EDGE_IDS)
+			eIds.resize(numberOfUpdates);
+		for (size_t i = 0, pos = 0; i < numberOfUpdates; pos += cardinalities[i++]) {
+			if (flags & DENSE_IDS)
+				remap(ids.data() + pos, ids.data() + pos + cardinalities[i]);
+			if (flags & EDGE_IDS)
+				eIds[i] = resolve((Update)types[i], ids.data() + pos, ids.data() + pos + cardinalities[i]);
+		}
+		// Deletions are resolved now, so the edges that are still alive need not be remembered
+		unordered_map<Hyperedge, vector<unsigned>, vectorHash>().swap(liveEdges);
+	}
+
+	cerr << "Finished. " << numberOfUpdates << " updates." << endl;
+}
+
+void GraphScheduler::scanStats() {
+	vector<Chunk> chunks;
+	parseChunks(chunks, false);
+	cerr << "Scanned. " << numberOfUpdates << " updates." << endl;
+}
+
+void GraphScheduler::produce() {
+	EdgeUpdate *slot;
+	if (binary) {
+		for (size_t i = 0; i < numberOfUpdates && (slot = buffer->acquireWrite()) != NULL; ++i) {
+			decodeUpdate(cursor, file.data() + file.size(), lastTimestamp, *slot);
+			if (flags & DENSE_IDS)
+				remap(slot->e.data(), slot->e.data() + slot->e.size());
+			if (flags & EDGE_IDS)
+				slot->eId = resolve(slot->updType, slot->e.data(), slot->e.data() + slot->e.size());
+			slot->offset = cursor - file.data();
+			buffer->commitWrite();
+		}
+		buffer->close();
+		return;
+	}
+	const char *p = file.data() == NULL ? NULL : file.data() + startOffset, *end = file.data() + file.size();
+	while (p != NULL && (slot = buffer->acquireWrite()) != NULL) {
+		slot->e.clear();
+		if ((p = parseUpdate(p, end, slot->updType, slot->timestamp, slot->e)) == NULL)
+			break;
+		if (flags & DENSE_IDS)
+			remap(slot->e.data(), slot->e.data() + slot->e.size());
+		if (flags & EDGE_IDS)
+			slot->eId = resolve(slot->updType, slot->e.data(), slot->e.data() + slot->e.size());
+		slot->offset = p - file.data();
+		buffer->commitWrite();
+	}
+	buffer->close();
+}
+
+void GraphScheduler::produceLive() {
+	// Every complete line is parsed as soon as it has been read; a partial line waits in pending for the rest of it
+	static const size_t READ_SIZE = 1 << 16;
+	vector<char> pending;
+	size_t consumed = startOffset; // Bytes of the input before pending
+	bool accepted = true;
+	while (accepted) {
+		const size_t start = pending.size();
+		pending.resize(start + READ_SIZE);
+		const int n = readInput(input, pending.data() + start, READ_SIZE);
+		pending.resize(start + max(n, 0));
+		if (n <= 0) break;
+		const chrono::steady_clock::time_point arrival = chrono::steady_clock::now();
+		const char *p = pending.data(), *end = p + pending.size(), *lineEnd = p + start;
+		while (accepted && (lineEnd = (const char *)memchr(lineEnd, '\n', end - lineEnd)) != NULL) {
+			++lineEnd;
+			accepted = emitLine(p, lineEnd, arrival, consumed + (lineEnd - pending.data()));
+			p = lineEnd;
+		}
+		consumed += p - pending.data();
+		pending.erase(pending.begin(), pending.begin() + (p - pending.data()));
+	}
+	// The last line may lack a line break
+	if (accepted)
+		emitLine(pending.data(), pending.data() + pending.size(), chrono::steady_clock::now(), consumed + pending.size());
+	buffer->close();
+}
+
+bool GraphScheduler::emitLine(const char *p, const char *end, chrono::steady_clock::time_point arrival, size_t offset) {
+	EdgeUpdate *slot = buffer->acquireWrite();
+	if (slot == NULL)
+		return false;
+	slot->e.clear();
+	// A blank line leaves the slot to the next update
+	if (parseUpdate(p, end, slot->updType, slot->timestamp, slot->e) == NULL)
+		return true;
+	if (flags & DENSE_IDS)
+		remap(slot->e.data(), slot->e.data() + slot->e.size());
+	if (flags & EDGE_IDS)
+		slot->eId = resolve(slot->updType, slot->e.data(), slot->e.data() + slot->e.size());
+	slot->arrival = arrival;
+	slot->offset = offset;
+	buffer->commitWrite();
+	return true;
+}
+
+void GraphScheduler::releaseHeld() {
+	if (held != NULL) {
+		// Hand the slot of the previous update back to the producer
+		buffer->commitRead();
+		held = NULL;
+	}
+}
+
+bool GraphScheduler::ready(chrono::steady_clock::time_point deadline) {
+	if (!(flags & STREAMING))
+		return true;
+	releaseHeld();
+	return current != NULL || buffer->waitRead(deadline);
+}
+
+bool GraphScheduler::streamHasNext() {
+	releaseHeld();
+	if (current == NULL)
+		current = buffer->acquireRead();
+	return current != NULL;
+}
+
+const EdgeUpdate& GraphScheduler::nextUpdate() {
+	if (flags & STREAMING) {
+		held = current;
+		current = NULL;
+		++position;
+		lastOffset = held->offset;
+		if (held->updType == INS)
+			lastInsertion = held->timestamp;
+		return *held;
+	}
+	// Decode or copy the update into lastUpdate, whose vector keeps its capacity between calls
+	if (binary) {
+		decodeUpdate(cursor, file.data() + file.size(), lastTimestamp, lastUpdate);
+		if (flags & DENSE_IDS)
+			remap(lastUpdate.e.data(), lastUpdate.e.data() + lastUpdate.e.size());
+		if (flags & EDGE_IDS)
+			lastUpdate.eId = resolve(lastUpdate.updType, lastUpdate.e.data(), lastUpdate.e.data() + lastUpdate.e.size());
+		++position;
+		lastInsertion = lastTimestamp;
+		return lastUpdate;
+	}
+	lastUpdate.updType = (Update)types[position];
+	lastUpdate.timestamp = timestamps[position];
+	lastUpdate.e.assign(ids.begin() + idPosition, ids.begin() + idPosition + cardinalities[position]);
+	if (flags & EDGE_IDS)
+		lastUpdate.eId = eIds[position];
+	if (lastUpdate.updType == INS)
+		lastInsertion = lastUpdate.timestamp;
+	idPosition += cardinalities[position++];
+	return lastUpdate;
+}
+
+size_t GraphScheduler::offset() {
+	if (flags & STREAMING)
+		return lastOffset;
+	if (binary)
+		return cursor - file.data();
+	// The offsets of preloaded updates are not kept, so parse forward from where the previous call stopped
+	vector<Node> endpoints;
+	Update updType;
+	int timestamp;
+	for (; offsetPosition < position; ++offsetPosition) {
+		offsetCursor = parseUpdate(offsetCursor, file.data() + file.size(), updType, timestamp, endpoints);
+		endpoints.clear();
+	}
+	return offsetCursor == NULL ? startOffset : offsetCursor - file.data();
+}
+
+unsigned long long GraphScheduler::prefixHash(size_t offset) {
+	if (file.data() == NULL || offset > file.size())
+		return 0;
+	// 64-bit FNV-1a
+	const size_t begin = binary ? min(offset, BINARY_HEADER_SIZE) : 0;
+	if (offset < hashedBytes || hashedBytes < begin || hashedBytes == 0) {
+		hashedBytes = begin;
+		hashValue = 14695981039346656037ULL;
+	}
+	for (const unsigned char *p = (const unsigned char *)file.data(); hashedBytes < offset; ++hashedBytes) {
+		hashValue ^= p[hashedBytes];
+		hashValue *= 1099511628211ULL;
+	}
+	return hashValue;
+}
+
+vector<Node> GraphScheduler::originalIds(size_t n) {
+	lock_guard<mutex> lock(idMutex);
+	return vector<Node>(toOriginal.begin(), toOriginal.begin() + min(n, toOriginal.size()));
+}
+
+void GraphScheduler::restoreEdges(const Hypergraph& h) {
+	// Deletions may resolve to every copy of an edge alive in h, and the IDs of the other records are free.
+	// The free IDs are listed from the largest down, so the smallest is handed out first.
+	vector<unsigned> freeIds;
+	Hyperedge e;
+	for (unsigned eId = h.edgeIdCounter; eId-- > 0;) {
+		if (h.edgeMultiplicity[eId] == 0) {
+			freeIds.push_back(eId);
+			continue;
+		}
+		const EdgeRange range = h.edge(eId);
+		e.assign(range.begin(), range.end());
+		vector<unsigned>& copies = liveEdges[e];
+		copies.insert(copies.end(), h.edgeMultiplicity[eId], eId);
+	}
+	edgeIds.assign(h.edgeIdCounter, freeIds);
+}
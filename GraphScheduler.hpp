@@ -1,30 +1,162 @@
-#ifndef __GRAPHSCHEDULER__
-#define __GRAPHSCHEDULER__
-
-#include <vector>
-#include <fstream>
-#include "Hypergraph.hpp"
-
-enum Update {INS, DEL};
-
-struct EdgeUpdate {
-	Hyperedge e;
-	int timestamp;
-	Update updType;
-};
-
-class GraphScheduler {
-public:
-	GraphScheduler(const char fileName[]);
-	EdgeUpdate nextUpdate();
-	inline bool hasNext() {
-		return position < updates.size();
-	}
-	unsigned numberOfNodes, maxDegree;
-private:
-	void load();
-	std::vector<EdgeUpdate> updates;
-	std::ifstream fin;
-	unsigned position;
-};
-#endif
+#ifndef __GRAPHSCHEDULER__
+#define __GRAPHSCHEDULER__
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <unordered_map>
+#include "Hypergraph.hpp"
+#include "MappedFile.hpp"
+#include "RingBuffer.hpp"
+
+enum Update {INS, DEL};
+
+enum SchedulerFlag {
+	STREAMING = 1, // Parse on a background thread into a bounded buffer instead of preloading all updates
+	DENSE_IDS = 2, // Renumber the nodes 0, 1, ..., numberOfNodes - 1 in order of first appearance
+	EDGE_IDS = 4, // Number the inserted edges and resolve every deletion to the ID of a matching earlier insertion
+	COLLAPSE_PARALLEL = 8, // With EDGE_IDS, give all parallel copies of an edge the same ID (see Hypergraph::edgeMultiplicity)
+	NO_PRESCAN = 16, // With STREAMING, skip the pass that collects the statistics, which then stay 0 (for engines that grow on demand)
+	DEFERRED = 32 // Read no update before start() is called, e.g. after restoring a checkpoint
+};
+
+struct EdgeUpdate {
+	Hyperedge e;
+	int timestamp;
+	Update updType;
+	unsigned eId; // With EDGE_IDS: the ID of the inserted edge, or that of the edge to delete
+	std::chrono::steady_clock::time_point arrival; // For a live input: when the line of the update was read
+	size_t offset; // With STREAMING: the byte offset in the log right after the update
+};
+
+class GraphScheduler {
+public:
+	// A fileName of "-" (standard input) or of a named pipe is a live input: its lines are parsed as they arrive,
+	// until the writer closes it. This implies STREAMING, and the statistics stay 0 (see NO_PRESCAN).
+	GraphScheduler(const char fileName[], unsigned flags = 0);
+	~GraphScheduler();
+	// With DEFERRED, start reading the log at byte offset, right after its first `updates` updates (see offset() and updates()).
+	// lastTimestamp is the timestamp of the last insertion before offset, which a binary log needs.
+	// originalIds are the input IDs of the nodes that have dense IDs already, and h holds the edges that are alive at offset,
+	// with the IDs that deletions have to resolve to.
+	void start(size_t offset = 0, size_t updates = 0, int lastTimestamp = 0, const std::vector<Node> *originalIds = NULL, const Hypergraph *h = NULL);
+	// The returned reference stays valid until the next call to hasNext()
+	const EdgeUpdate& nextUpdate();
+	inline bool hasNext() {
+		if (!(flags & STREAMING))
+			return position < numberOfUpdates;
+		return streamHasNext();
+	}
+	// Translate trailing command-line words (e.g. "stream") into scheduler flags.
+	// Words of the form name=value are options of the algorithms and are left to option().
+	static unsigned parseFlags(int argc, char **argv, int first);
+	// The value of the trailing command-line word name=value, or NULL if there is none
+	static const char *option(int argc, char **argv, int first, const char *name);
+	bool live() const {
+		return input >= 0;
+	}
+	// The flags that decide the node and edge IDs handed out, which a checkpoint has to be restored with
+	unsigned idFlags() const {
+		return flags & (DENSE_IDS | EDGE_IDS | COLLAPSE_PARALLEL);
+	}
+	// Where the log continues after the updates handed out so far: the byte offset, the number of updates from the beginning of the log
+	// and the timestamp of the last insertion. For a live input the offset counts the bytes read, which cannot be skipped on a restart.
+	size_t offset();
+	size_t updates() const {
+		return first + position;
+	}
+	int lastInsertionTimestamp() const {
+		return lastInsertion;
+	}
+	// A hash of the first offset bytes of the log, which tells whether a checkpoint was taken on this log.
+	// The header of a binary log is left out, since its counts change when the log grows.
+	// 0 for a live input, whose bytes are not kept, and for an offset past the end of the log.
+	// Hashing goes on from the previous call when offset has not decreased, so calling it at every checkpoint reads the log once.
+	unsigned long long prefixHash(size_t offset);
+	// With DENSE_IDS, the input IDs of the dense IDs 0, 1, ..., n - 1
+	std::vector<Node> originalIds(size_t n);
+	// Wait until hasNext() can answer without waiting, or until deadline; returns false if the deadline has passed.
+	// Like hasNext(), this invalidates the reference returned by nextUpdate().
+	bool ready(std::chrono::steady_clock::time_point deadline);
+	// The number of updates that have been read but not handed out yet.
+	// On a live input, 0 means that the next call to hasNext() may wait for the writer.
+	size_t queued() const;
+	// Parse the update starting at p and append its sorted endpoints to ids.
+	// Returns the position after the update, or NULL if there is no update in [p, end).
+	static const char *parseUpdate(const char *p, const char *end, Update& updType, int& timestamp, std::vector<Node>& ids);
+	// Decode the update of a binary log (see BinaryFormat.hpp) starting at p and advance p past it.
+	// lastTimestamp is the timestamp of the previous insertion and is updated for insertions.
+	static void decodeUpdate(const char *&p, const char *end, int& lastTimestamp, EdgeUpdate&);
+	// With DENSE_IDS, translate between the node IDs of the input and those of the updates.
+	// denseId() returns false for a node that has not appeared (yet).
+	bool denseId(Node original, Node& dense);
+	Node originalId(Node dense);
+	size_t numberOfUpdates;
+	unsigned numberOfNodes, maxDegree, maxCardinality;
+private:
+	// The input is split at line boundaries into chunks that are parsed in parallel
+	struct Chunk {
+		const char *begin, *end;
+		size_t nUpdates;
+		unsigned maxCardinality;
+		std::vector<Node> ids;
+		std::vector<unsigned> cardinalities;
+		std::vector<int> timestamps;
+		std::vector<unsigned char> types;
+		// Endpoints of the insertions of this chunk, split into partitions of the node IDs that are counted in parallel.
+		// When the updates are not kept, endpoints are folded into per-node counters every FOLD_SIZE occurrences.
+		std::vector<std::vector<Node>> endpoints;
+		std::vector<std::unordered_map<Node, unsigned>> deg;
+	};
+	static const size_t FOLD_SIZE = 1 << 20;
+	void load();
+	void scanStats();
+	void parseChunks(std::vector<Chunk>&, bool keepUpdates);
+	// Dense IDs are assigned by whichever thread produces the updates; the mutex guards the maps against readers on other threads
+	std::unordered_map<Node, Node> toDense;
+	std::vector<Node> toOriginal;
+	std::mutex idMutex;
+	void remap(Node *begin, Node *end);
+	// Live edges by their endpoints, for resolving deletions (see EDGE_IDS).
+	// A preloaded log is resolved in load(), so the map is only kept while decoding or streaming.
+	std::unordered_map<Hyperedge, std::vector<unsigned>, vectorHash> liveEdges;
+	Hyperedge key;
+	EdgeIdAllocator edgeIds;
+	unsigned resolve(Update updType, const Node *begin, const Node *end);
+	void restoreEdges(const Hypergraph&);
+	static bool isLive(const char fileName[]);
+	int input; // The descriptor of a live input, or -1
+	MappedFile file;
+	unsigned flags;
+	// Binary logs are decoded straight from the mapped file instead of being preloaded
+	bool binary;
+	const char *cursor;
+	int lastTimestamp;
+	// Preloaded updates, stored flat: update i has cardinalities[i] endpoints in ids, right after those of update i - 1
+	std::vector<Node> ids;
+	std::vector<unsigned> cardinalities;
+	std::vector<int> timestamps;
+	std::vector<unsigned char> types;
+	std::vector<unsigned> eIds;
+	size_t position, idPosition;
+	EdgeUpdate lastUpdate;
+	// Resuming: the updates and bytes of the log that come before the first update read, and what offset() needs
+	size_t first, startOffset, lastOffset, offsetPosition;
+	const char *offsetCursor;
+	int lastInsertion;
+	size_t hashedBytes;
+	unsigned long long hashValue;
+	// Streaming mode
+	static const size_t STREAM_BUFFER_SIZE = 1 << 16;
+	RingBuffer<EdgeUpdate> *buffer;
+	EdgeUpdate *current, *held;
+	std::thread producer;
+	bool streamHasNext();
+	void releaseHeld();
+	void produce();
+	void produceLive();
+	// Parse the update in [p, end) into a slot of the buffer; returns false if the buffer has been closed
+	bool emitLine(const char *p, const char *end, std::chrono::steady_clock::time_point arrival, size_t offset);
+};
+#endif
@@ -1,28 +1,134 @@
-#include "Hypergraph.hpp"
-#include <iostream>
-using namespace std;
-
-Hypergraph::Hypergraph() {
-	nNodes = nEdges = edgeIdCounter = 0;
-}
-
-unsigned Hypergraph::insertEdge(const Hyperedge& e) {
-	// Insert an edge to the hypergraph
-	edge2id.insert(pair<const Hyperedge, unsigned>(e, edgeIdCounter));
-	for (const Node u: e)
-		eList[u].insert(edgeIdCounter);
-	edgePool.push_back(e);
-	// ++edgeIdCounter;
-	++nEdges;
-	return edgeIdCounter++;
-}
-
-void Hypergraph::deleteEdge(const Hyperedge& e) {
-	// Delete an edge from the hypergraph
-	auto iter = edge2id.find(e);
-	for (const Node u: e)
-		eList[u].erase(iter->second);
-	edgePool[iter->second].clear();
-	edge2id.erase(iter);
-	--nEdges;
-}
+#include "Hypergraph.hpp"
+#include <iostream>
+#include <algorithm>
+#include "Checkpoint.hpp"
+using namespace std;
+
+Hypergraph::Hypergraph() {
+	nNodes = nEdges = edgeIdCounter = 0;
+	garbage = 0;
+}
+
+unsigned Hypergraph::insertEdge(const Hyperedge& e) {
+	// Insert an edge to the hypergraph
+	unsigned eId = edgeIds.acquire();
+	edge2id.insert(pair<const Hyperedge, unsigned>(e, eId));
+	return insertEdge(e, eId);
+}
+
+void Hypergraph::deleteEdge(const Hyperedge& e) {
+	// Delete an edge from the hypergraph
+	auto iter = edge2id.find(e);
+	unsigned eId = iter->second;
+	edge2id.erase(iter);
+	deleteEdgeById(eId);
+	edgeIds.release(eId);
+}
+
+unsigned Hypergraph::insertEdge(const Hyperedge& e, unsigned eId) {
+	++nEdges;
+	if (eId < edgeIdCounter && edgeMultiplicity[eId] > 0) {
+		++edgeMultiplicity[eId];
+		for (const Node u: e)
+			++degree[u];
+		return eId;
+	}
+	if (eId >= edgeIdCounter) {
+		edgeIdCounter = eId + 1;
+		edgeBegin.resize(edgeIdCounter);
+		edgeSize.resize(edgeIdCounter);
+		edgeMultiplicity.resize(edgeIdCounter);
+	}
+	edgeBegin[eId] = edgePool.size();
+	edgeSize[eId] = e.size();
+	edgeMultiplicity[eId] = 1;
+	for (unsigned k = 0; k < e.size(); ++k) {
+		const Node u = e[k];
+		if (u >= eList.size()) {
+			eList.resize(u + 1);
+			eListSlot.resize(u + 1);
+			degree.resize(u + 1);
+			nNodes = eList.size();
+		}
+		++degree[u];
+		edgePool.push_back(u);
+		eListPos.push_back(eList[u].size());
+		eList[u].push_back(eId);
+		eListSlot[u].push_back(k);
+	}
+	return eId;
+}
+
+void Hypergraph::deleteEdgeById(unsigned eId) {
+	--nEdges;
+	for (const Node u: edge(eId))
+		--degree[u];
+	if (--edgeMultiplicity[eId] > 0)
+		return;
+	for (size_t i = edgeBegin[eId]; i < edgeBegin[eId] + edgeSize[eId]; ++i) {
+		// Move the last edge of eList[u] into the place of this one
+		const Node u = edgePool[i];
+		const unsigned pos = eListPos[i], last = eList[u].back(), lastSlot = eListSlot[u].back();
+		eList[u][pos] = last;
+		eListSlot[u][pos] = lastSlot;
+		eListPos[edgeBegin[last] + lastSlot] = pos;
+		eList[u].pop_back();
+		eListSlot[u].pop_back();
+	}
+	garbage += edgeSize[eId];
+	edgeSize[eId] = 0;
+	// compact() goes through all edge IDs, so it waits for garbage in proportion to them as well as to the pool
+	if (garbage > max(edgePool.size(), (size_t)edgeIdCounter) / 2)
+		compact();
+}
+
+void Hypergraph::compact() {
+	// Copy the endpoints of the remaining edges together in the order of their IDs, which do not change
+	vector<Node> pool;
+	vector<unsigned> pos;
+	pool.reserve(edgePool.size() - garbage);
+	pos.reserve(edgePool.size() - garbage);
+	for (unsigned eId = 0; eId < edgeIdCounter; ++eId) {
+		if (edgeSize[eId] == 0) continue;
+		size_t begin = edgeBegin[eId];
+		edgeBegin[eId] = pool.size();
+		pool.insert(pool.end(), edgePool.begin() + begin, edgePool.begin() + begin + edgeSize[eId]);
+		pos.insert(pos.end(), eListPos.begin() + begin, eListPos.begin() + begin + edgeSize[eId]);
+	}
+	edgePool.swap(pool);
+	eListPos.swap(pos);
+	garbage = 0;
+}
+
+void Hypergraph::save(CheckpointWriter& out) const {
+	out.put(nNodes);
+	out.put(nEdges);
+	out.put(edgeIdCounter);
+	out.put((unsigned long long)garbage);
+	out.put(edgePool);
+	out.put(eListPos);
+	out.put(edgeBegin);
+	out.put(edgeSize);
+	out.put(edgeMultiplicity);
+	out.put(eList);
+	out.put(eListSlot);
+	out.put(degree);
+}
+
+void Hypergraph::load(CheckpointReader& in) {
+	unsigned long long g = 0;
+	in.get(nNodes);
+	in.get(nEdges);
+	in.get(edgeIdCounter);
+	in.get(g);
+	garbage = g;
+	in.get(edgePool);
+	in.get(eListPos);
+	in.get(edgeBegin);
+	in.get(edgeSize);
+	in.get(edgeMultiplicity);
+	in.get(eList);
+	in.get(eListSlot);
+	in.get(degree);
+	edge2id.clear();
+}
@@ -1,33 +1,97 @@
-#ifndef __HYPERGRAPH__
-#define __HYPERGRAPH__
-
-#include <vector>
-#include <unordered_set>
-#include <unordered_map>
-
-struct vectorHash {
-	std::size_t operator()(std::vector<unsigned> const& vec) const {
-		std::size_t seed = vec.size();
-		for(auto& i: vec) {
-			seed ^= i + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-		}
-		return seed;
-	}
-};
-
-typedef unsigned Node;
-typedef std::vector<Node> Hyperedge;
-
-class Hypergraph{
-public:
-	Hypergraph();
-	unsigned nNodes;
-	unsigned nEdges;
-	unsigned edgeIdCounter;
-	std::vector<Hyperedge> edgePool;
-	std::unordered_multimap<Hyperedge, unsigned, vectorHash> edge2id;
-	std::unordered_map<Node, std::unordered_set<unsigned>> eList;
-	unsigned insertEdge(const Hyperedge&);
-	void deleteEdge(const Hyperedge&);
-};
-#endif
+#ifndef __HYPERGRAPH__
+#define __HYPERGRAPH__
+
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+struct vectorHash {
+	std::size_t operator()(std::vector<unsigned> const& vec) const {
+		std::size_t seed = vec.size();
+		for(auto& i: vec) {
+			seed ^= i + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		}
+		return seed;
+	}
+};
+
+typedef unsigned Node;
+typedef std::vector<Node> Hyperedge;
+
+// The endpoints of an edge stored in Hypergraph::edgePool
+struct EdgeRange {
+	const Node *first, *last;
+	const Node *begin() const { return first; }
+	const Node *end() const { return last; }
+	std::size_t size() const { return last - first; }
+	Node operator[](std::size_t i) const { return first[i]; }
+};
+
+// Hands out edge IDs, reusing those of deleted edges first, so the IDs stay below the largest number of edges alive at a time
+class EdgeIdAllocator {
+public:
+	EdgeIdAllocator(): counter(0) {}
+	unsigned acquire() {
+		if (freeIds.empty())
+			return counter++;
+		unsigned eId = freeIds.back();
+		freeIds.pop_back();
+		return eId;
+	}
+	void release(unsigned eId) {
+		freeIds.push_back(eId);
+	}
+	// Continue after IDs below counter have been handed out, of which freeIds are free again
+	void assign(unsigned counter, const std::vector<unsigned>& freeIds) {
+		this->counter = counter;
+		this->freeIds = freeIds;
+	}
+private:
+	unsigned counter;
+	std::vector<unsigned> freeIds;
+};
+
+class Hypergraph{
+public:
+	Hypergraph();
+	unsigned nNodes;
+	unsigned nEdges;
+	unsigned edgeIdCounter; // One more than the largest edge ID that has been used
+	// Endpoints of all edges, back to back; edge eId has edgeSize[eId] endpoints from edgePool[edgeBegin[eId]] on (0 if deleted).
+	// Deleted edges leave their endpoints behind until the pool is compacted.
+	std::vector<Node> edgePool;
+	std::vector<unsigned> eListPos; // Parallel to edgePool: where the edge is stored in eList of that endpoint
+	std::vector<std::size_t> edgeBegin;
+	std::vector<unsigned> edgeSize;
+	std::vector<unsigned> edgeMultiplicity; // Number of parallel copies sharing the record of the edge (0 if deleted)
+	// Valid until the next insertion or deletion
+	inline EdgeRange edge(unsigned eId) const {
+		const Node *first = edgePool.data() + edgeBegin[eId];
+		EdgeRange range = {first, first + edgeSize[eId]};
+		return range;
+	}
+	std::unordered_multimap<Hyperedge, unsigned, vectorHash> edge2id;
+	// Indexed by node; grows to cover the largest node inserted.
+	// eList[u] holds the IDs of the edges incident to u in no particular order, and eListSlot[u][i] is the index of u among the endpoints of edge eList[u][i].
+	// An edge is removed by moving the last entry into its place.
+	std::vector<std::vector<unsigned>> eList, eListSlot;
+	std::vector<unsigned> degree; // Indexed by node: number of incident edges, parallel copies included
+	unsigned insertEdge(const Hyperedge&);
+	void deleteEdge(const Hyperedge&);
+	// Insert and delete edges whose IDs are chosen by the caller (e.g. GraphScheduler with EDGE_IDS).
+	// These do not maintain edge2id, so deletions need no lookup by endpoints.
+	// Inserting with the ID of an edge that is present adds a parallel copy to its record, and a deletion removes one copy.
+	unsigned insertEdge(const Hyperedge&, unsigned eId);
+	void deleteEdgeById(unsigned eId);
+	// Checkpoints of the edges and adjacency lists. edge2id is not kept, so only graphs whose edge IDs are chosen by the caller can be restored.
+	void save(CheckpointWriter&) const;
+	void load(CheckpointReader&);
+private:
+	EdgeIdAllocator edgeIds; // IDs of the edges inserted without an ID
+	std::size_t garbage; // Number of endpoints of deleted edges in edgePool
+	void compact();
+};
+#endif
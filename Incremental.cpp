@@ -1,259 +1,519 @@
-/*
-Our insertion-only algorithm.
-The code includes various functional blocks. Uncomment respective parts to examine different aspects of the execution.
-
-[To compile]
-g++ -std=c++11 -O3 Incremental.cpp GraphScheduler.cpp Hypergraph.cpp HypergraphCoreDecomp.cpp -o Incremental
-
-[To run]
-Incremental epsilon lambda filename
-
-[Format of input]
-The file should contain an update in each line.
-Hyperedge insertion: + [node IDs] timestamp
-So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
-The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
-*/
-
-#include <cstdio>
-#include <cmath>
-#include <ctime>
-#include <cassert>
-#include <iostream>
-#include <unordered_set>
-#include <unordered_map>
-#include "Hypergraph.hpp"
-#include "GraphScheduler.hpp"
-#include "HypergraphCoreDecomp.hpp"
-using namespace std;
-
-class Incremental {
-public:
-	Incremental(double epsilon, double lambda, char fileName[]): epsilon(epsilon), lambda(lambda), scheduler(fileName) {
-		initialize();
-	}
-	void run() {
-		FILE *ofpVal = fopen("StatIncrementalCoreValue.txt", "w");
-		FILE *ofpTime = fopen("StatIncrementalTime.txt", "w");
-		FILE *ofpDetail = fopen("StatIncrementalDetail.txt", "w");
-		int cnt = 0;
-		time_t t0 = clock(), totalTime = 0;
-		while (scheduler.hasNext()) {
-			EdgeUpdate edgeUpdate = scheduler.nextUpdate();
-			assert(edgeUpdate.updType == INS);
-			insertEdge(edgeUpdate.e);
-			++cnt;
-			if (cnt % 100000 == 0) {
-				fprintf(ofpTime, "%d\n", clock() - t0);
-				fprintf(stderr, "%d...\t", cnt);
-				fprintf(ofpVal, "%d\n", cnt);
-				/*
-				// Run the static exact algorithm
-				HypergraphCoreDecomp hcd(h);
-				hcd.solve();
-				unordered_map<int, int> coreCount, coreCountApprox;
-				for (auto& p: hcd.c) {
-					const Node u = p.first;
-					if (hcd.c[u] > 0) {
-						if (!coreCount.count(hcd.c[u]))
-							coreCount[hcd.c[u]] = 1;
-						else
-							++coreCount[hcd.c[u]];
-						if (!coreCountApprox.count(b[tau][u]))
-							coreCountApprox[b[tau][u]] = 1;
-						else
-							++coreCountApprox[b[tau][u]];
-					}
-				}
-				for (auto& p: coreCount)
-					fprintf(ofpVal, "%d %d\n", p.first, p.second);
-				fprintf(ofpVal, "-1\n");
-				for (auto& p: coreCountApprox)
-					fprintf(ofpVal, "%d %d\n", p.first, p.second);
-				fprintf(ofpVal, "-1\n");*/
-
-				/*vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
-				int cntNonZero = 0;
-				for (auto& p: hcd.c) {
-					const Node u = p.first;
-					if (hcd.c[u] > 0) {
-						++cntNonZero;
-						for (int t = 1; t <= tau; ++t) {
-							double err = max(((double)hcd.c[u]) / b[t][u], ((double)b[t][u]) / hcd.c[u]);
-							if (maxErr[t] < err)
-								maxErr[t] = err;
-							avgErr[t] += err;
-						}
-					}
-				}
-				for (int t = 1; t <= tau; ++t)
-					avgErr[t] /= cntNonZero;
-				for (int t = 1; t <= tau; ++t)
-					fprintf(ofpDetail, "%.9f%c", maxErr[t], t == tau ? '\n' : ' ');
-				for (int t = 1; t <= tau; ++t)
-					fprintf(ofpDetail, "%.9f%c", avgErr[t], t == tau ? '\n' : ' ');
-				*/
-				t0 = clock();
-			}
-		}
-	//	fclose(ofp);
-
-		/*
-		// Block: compare between different parameters
-		FILE *ofpComp = fopen("StatIncremental.txt", "w");
-		fprintf(ofpComp, "lambda = %f\n", lambda);
-		fprintf(ofpComp, "total time = %d ms\n", clock() - t0 - totalExcludedTime);
-		fprintf(ofpComp, "total number of updates = %d\n", cnt);
-		double maxErr = 0, avgErr = 0;
-		int cntNonZero = 0;
-		HypergraphCoreDecomp hcd(h);
-		hcd.solve();
-		for (auto& p: hcd.c) {
-			const Node u = p.first;
-			assert((hcd.c[u] == 0 && b[tau][u] == 0) || (hcd.c[u] > 0 && b[tau][u] > 0));
-			if (hcd.c[u] > 0) {
-				++cntNonZero;
-				double err = max((double)hcd.c[u] / b[tau][u], (double)b[tau][u] / hcd.c[u]);
-				maxErr = max(maxErr, err);
-				avgErr += err;
-			}
-		}
-		avgErr /= cntNonZero;
-		fprintf(ofpComp, "max error = %.9f\n", maxErr);
-		fprintf(ofpComp, "avg error = %.9f\n", avgErr);
-		fclose(ofpComp);
-		*/
-
-		/*
-		// Block: show that a large tau is unnecessary
-		vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
-		int cntNonZero = 0;
-		HypergraphCoreDecomp hcd(h);
-		hcd.solve();
-		for (auto& p: hcd.c) {
-			const Node u = p.first;
-			assert((hcd.c[u] == 0 && b[tau][u] == 0) || (hcd.c[u] > 0 && b[tau][u] > 0));
-			if (hcd.c[u] > 0) {
-				++cntNonZero;
-				for (int t = 1; t <= tau; ++t) {
-					if (maxErr[t] < max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]))
-						maxErr[t] = max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]);
-					avgErr[t] += max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]);
-				}
-			}
-		}
-		for (int t = 1; t <= tau; ++t)
-			avgErr[t] /= cntNonZero;
-
-		FILE *ofpLargeTau = fopen("LargeTauIsUnnecessaryIncremental.txt", "w");
-		fprintf(ofpLargeTau, "%d\n", tau);
-		for (int t = 1; t <= tau; ++t)
-			fprintf(ofpLargeTau, "%.9f %.9f\n", maxErr[t], avgErr[t]);
-		fclose(ofpLargeTau);*/
-	}
-	unsigned getApproxCoreVal(Node u) {
-		return b[tau][u];
-	}
-	Hypergraph h;
-private:
-	double epsilon, lambda;
-	GraphScheduler scheduler;
-
-	int tau;
-	vector<unsigned> succ, pred;
-	vector<unordered_map<Node, unsigned>> b, sigma;
-	void initialize() {
-		tau = ceil(0.15 * log(scheduler.numberOfNodes) / log(1.0 + epsilon));
-		// Build succ and pred
-		vector<unsigned> Lambda(1, 0);
-		int i = 0;
-		while (Lambda[i] <= scheduler.maxDegree) {
-			Lambda.push_back(max((unsigned)(Lambda[i] * (1.0 + lambda)), Lambda[i] + 1));
-			++i;
-		}
-		succ = pred = vector<unsigned>(Lambda[i] + 1);
-		for (int j = 0; j < i; ++j)
-			succ[Lambda[j]] = Lambda[j + 1], pred[Lambda[j + 1]] = Lambda[j];
-		b.resize(tau + 1);
-		sigma.resize(tau + 1);
-		cerr << "Lambda: ";
-		for (auto& lambda: Lambda) cerr << lambda << ' ';
-		cerr << endl;
-		cerr << "# of nodes = " << scheduler.numberOfNodes << endl;
-		cerr << "tau = " << tau << endl;
-		cerr << "max degree = " << scheduler.maxDegree << endl;
-	}
-	void insertEdge(const Hyperedge& e) {
-	//	cerr << "Insert an edge" << endl;
-		h.insertEdge(e);
-		unordered_set<Node> bad, bad2;
-		for (const Node u: e)
-			++sigma[1][u], bad.insert(u);
-		for (unsigned t = 1; t <= tau; ++t) {
-			bad2.clear();
-			if (t < tau) {
-				unsigned b_e = INT_MAX;
-				for (const Node u: e)
-					b_e = min(b_e, b[t][u]);
-				for (const Node u: e) {
-					if (b_e >= succ[b[t + 1][u]])
-						++sigma[t + 1][u], bad2.insert(u);
-				}
-			}
-			for (const Node u: bad)
-				if (sigma[t][u] >= succ[b[t][u]])
-					promote(t, u, bad2);
-			swap(bad, bad2);
-		}
-	}
-	void promote(const unsigned t, const Node u, unordered_set<Node>& bad2) {
-	//	cerr << "Promote " << t << ' ' << u << ' ' << newEdgeId << endl;
-		unsigned old_b_t_u = b[t][u];
-		b[t][u] = succ[b[t][u]];
-		updateSigma(t, u);
-	//	cerr << "b[" << t << "][" << u << "] = " << b[t][u] << ", sigma[" << t << "][" << u << "] = " << sigma[t][u] << endl;
-		if (t == tau) return;
-		for (const unsigned eId: h.eList[u]) {
-	//		cerr << "eId = " << eId << endl;
-			const Hyperedge& e = h.edgePool[eId];
-			unsigned old_b_e = INT_MAX;
-			for (const Node v: e)
-				if (v != u)
-					old_b_e = min(old_b_e, b[t][v]);
-			unsigned new_b_e = min(old_b_e, b[t][u]);
-			old_b_e = min(old_b_e, old_b_t_u);
-			if (new_b_e == old_b_e) continue;
-			for (const Node v: e) {
-				if (old_b_e < succ[b[t + 1][v]]
-							&& succ[b[t + 1][v]] <= new_b_e)
-					++sigma[t + 1][v], bad2.insert(v);
-			}
-		}
-	//	cerr << "Promote finished." << endl;
-	}
-	void updateSigma(unsigned t, Node u) {
-		sigma[t][u] = 0;
-		for (const unsigned eId: h.eList[u]) {
-			const Hyperedge& e = h.edgePool[eId];
-			unsigned b_e = INT_MAX;
-			if (t > 1)
-				for (const Node v: e)
-					b_e = min(b_e, b[t - 1][v]);
-			if (b_e >= succ[b[t][u]]) ++sigma[t][u];
-		}
-	}
-};
-
-int main(int argc, char **argv) {
-	double epsilon = atof(argv[1]);
-	double lambda = atof(argv[2]);
-	char *fileName = argv[3];
-	Incremental incremental(epsilon, lambda, fileName);
-	time_t t = clock();
-	incremental.run();
-	cerr << (clock() - t) << " ms." << endl;
-//	Node u;
-//	while (cin >> u)
-//		cout << incremental.getApproxCoreVal(u) << endl;
-	return 0;
-}
+/*
+Our insertion-only algorithm.
+The code includes various functional blocks. Uncomment respective parts to examine different aspects of the execution.
+
+[To compile]
+g++ -std=c++11 -O3 Incremental.cpp GraphScheduler.cpp Hypergraph.cpp HypergraphCoreDecomp.cpp -pthread -o Incremental
+
+[To run]
+Incremental epsilon lambda filename [stream] [collapse] [report=updates] [interval=seconds] [values=filename] [checkpoint=filename] [restore=filename]
+A filename of "-" (or a named pipe) reads the updates live, as a producer writes them.
+checkpoint= saves the state at every report and at the end; restore= resumes from such a checkpoint with the rest of the same log.
+
+[Format of input]
+The file should contain an update in each line.
+Hyperedge insertion: + [node IDs] timestamp
+So be careful that the last number of a line beginning with "+" is not an endpoint of the inserted hyperedge.
+The timestamps are actually useless (for our purpose). You will need them only when you want to trace the insertion time of hyperedges.
+*/
+
+#include <cstdio>
+#include <cmath>
+#include <climits>
+#include <ctime>
+#include <cassert>
+#include <iostream>
+#include <unordered_set>
+#include <unordered_map>
+#include "Hypergraph.hpp"
+#include "GraphScheduler.hpp"
+#include "HypergraphCoreDecomp.hpp"
+#include "Worklist.hpp"
+#include "UpdateStats.hpp"
+#include "CoreSnapshot.hpp"
+#include "Checkpoint.hpp"
+using namespace std;
+
+class Incremental {
+public:
+	// See FullyDynamic::FullyDynamic() for checkpoint
+	Incremental(double epsilon, double lambda, char fileName[], unsigned schedulerFlags = 0, const char *checkpoint = NULL):
+		epsilon(epsilon), lambda(lambda), scheduler(fileName, schedulerFlags | DENSE_IDS | EDGE_IDS | NO_PRESCAN | (checkpoint != NULL ? DEFERRED : 0)) {
+		if (checkpoint != NULL && loadCheckpoint(checkpoint))
+			return;
+		if (checkpoint != NULL) {
+			cerr << "Cannot restore from " << checkpoint << ", reading " << fileName << " from the beginning" << endl;
+			scheduler.start();
+		}
+		initialize();
+	}
+	// See FullyDynamic::run() for the parameters
+	void run(size_t reportEvery = 100000, double reportInterval = 0, const char *valuesFile = NULL, const char *checkpointFile = NULL) {
+		FILE *ofpVal = fopen("StatIncrementalCoreValue.txt", "w");
+		FILE *ofpTime = fopen("StatIncrementalTime.txt", "w");
+		FILE *ofpDetail = fopen("StatIncrementalDetail.txt", "w");
+		int cnt = 0;
+		time_t t0 = clock(), totalTime = 0;
+		UpdateStats stats(reportEvery, reportInterval);
+		while (true) {
+			// See FullyDynamic::run()
+			const bool idle = scheduler.live() && reportInterval > 0 && !scheduler.ready(stats.deadline());
+			if (!idle) {
+				if (!scheduler.hasNext()) break;
+				const EdgeUpdate& edgeUpdate = scheduler.nextUpdate();
+				assert(edgeUpdate.updType == INS);
+				insertEdge(edgeUpdate.e, edgeUpdate.eId);
+				stats.applied(edgeUpdate);
+				++cnt;
+			}
+			if (stats.due(cnt)) {
+				fprintf(ofpTime, "%d\n", clock() - t0);
+				stats.report(cnt);
+				if (valuesFile != NULL)
+					writeCoreValues(valuesFile);
+				if (checkpointFile != NULL && !saveCheckpoint(checkpointFile))
+					cerr << "Cannot write the checkpoint " << checkpointFile << endl;
+				fprintf(ofpVal, "%d\n", cnt);
+				/*
+				// Run the static exact algorithm
+				HypergraphCoreDecomp hcd(h);
+				hcd.solve();
+				unordered_map<int, int> coreCount, coreCountApprox;
+				for (auto& p: hcd.c) {
+					const Node u = p.first;
+					if (hcd.c[u] > 0) {
+						if (!coreCount.count(hcd.c[u]))
+							coreCount[hcd.c[u]] = 1;
+						else
+							++coreCount[hcd.c[u]];
+						if (!coreCountApprox.count(b[tau][u]))
+							coreCountApprox[b[tau][u]] = 1;
+						else
+							++coreCountApprox[b[tau][u]];
+					}
+				}
+				for (auto& p: coreCount)
+					fprintf(ofpVal, "%d %d\n", p.first, p.second);
+				fprintf(ofpVal, "-1\n");
+				for (auto& p: coreCountApprox)
+					fprintf(ofpVal, "%d %d\n", p.first, p.second);
+				fprintf(ofpVal, "-1\n");*/
+
+				/*vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
+				int cntNonZero = 0;
+				for (auto& p: hcd.c) {
+					const Node u = p.first;
+					if (hcd.c[u] > 0) {
+						++cntNonZero;
+						for (int t = 1; t <= tau; ++t) {
+							double err = max(((double)hcd.c[u]) / b[t][u], ((double)b[t][u]) / hcd.c[u]);
+							if (maxErr[t] < err)
+								maxErr[t] = err;
+							avgErr[t] += err;
+						}
+					}
+				}
+				for (int t = 1; t <= tau; ++t)
+					avgErr[t] /= cntNonZero;
+				for (int t = 1; t <= tau; ++t)
+					fprintf(ofpDetail, "%.9f%c", maxErr[t], t == tau ? '\n' : ' ');
+				for (int t = 1; t <= tau; ++t)
+					fprintf(ofpDetail, "%.9f%c", avgErr[t], t == tau ? '\n' : ' ');
+				*/
+				t0 = clock();
+			}
+		}
+		if (valuesFile != NULL)
+			writeCoreValues(valuesFile);
+		if (checkpointFile != NULL && !saveCheckpoint(checkpointFile))
+			cerr << "Cannot write the checkpoint " << checkpointFile << endl;
+	//	fclose(ofp);
+
+		/*
+		// Block: compare between different parameters
+		FILE *ofpComp = fopen("StatIncremental.txt", "w");
+		fprintf(ofpComp, "lambda = %f\n", lambda);
+		fprintf(ofpComp, "total time = %d ms\n", clock() - t0 - totalExcludedTime);
+		fprintf(ofpComp, "total number of updates = %d\n", cnt);
+		double maxErr = 0, avgErr = 0;
+		int cntNonZero = 0;
+		HypergraphCoreDecomp hcd(h);
+		hcd.solve();
+		for (auto& p: hcd.c) {
+			const Node u = p.first;
+			assert((hcd.c[u] == 0 && b[tau][u] == 0) || (hcd.c[u] > 0 && b[tau][u] > 0));
+			if (hcd.c[u] > 0) {
+				++cntNonZero;
+				double err = max((double)hcd.c[u] / b[tau][u], (double)b[tau][u] / hcd.c[u]);
+				maxErr = max(maxErr, err);
+				avgErr += err;
+			}
+		}
+		avgErr /= cntNonZero;
+		fprintf(ofpComp, "max error = %.9f\n", maxErr);
+		fprintf(ofpComp, "avg error = %.9f\n", avgErr);
+		fclose(ofpComp);
+		*/
+
+		/*
+		// Block: show that a large tau is unnecessary
+		vector<double> maxErr(tau + 1, 0), avgErr(tau + 1, 0);
+		int cntNonZero = 0;
+		HypergraphCoreDecomp hcd(h);
+		hcd.solve();
+		for (auto& p: hcd.c) {
+			const Node u = p.first;
+			assert((hcd.c[u] == 0 && b[tau][u] == 0) || (hcd.c[u] > 0 && b[tau][u] > 0));
+			if (hcd.c[u] > 0) {
+				++cntNonZero;
+				for (int t = 1; t <= tau; ++t) {
+					if (maxErr[t] < max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]))
+						maxErr[t] = max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]);
+					avgErr[t] += max((double)hcd.c[u] / b[t][u], (double)b[t][u] / hcd.c[u]);
+				}
+			}
+		}
+		for (int t = 1; t <= tau; ++t)
+			avgErr[t] /= cntNonZero;
+
+		FILE *ofpLargeTau = fopen("LargeTauIsUnnecessaryIncremental.txt", "w");
+		fprintf(ofpLargeTau, "%d\n", tau);
+		for (int t = 1; t <= tau; ++t)
+			fprintf(ofpLargeTau, "%.9f %.9f\n", maxErr[t], avgErr[t]);
+		fclose(ofpLargeTau);*/
+	}
+	// Write a line "node value" for every node with a positive approximate core value, replacing the previous snapshot at once
+	void writeCoreValues(const char *fileName) {
+		FILE *ofp = fopen((string(fileName) + ".tmp").c_str(), "w");
+		if (ofp == NULL) return;
+		for (Node u = 0; u < b[tau].size(); ++u)
+			if (b[tau][u] > 0)
+				fprintf(ofp, "%u %u\n", scheduler.originalId(u), b[tau][u]);
+		fclose(ofp);
+		UpdateStats::publish(fileName);
+	}
+	// See FullyDynamic::saveCheckpoint() and loadCheckpoint()
+	bool saveCheckpoint(const char *fileName) {
+		CheckpointHeader header = {};
+		strncpy(header.algorithm, "Incremental", sizeof(header.algorithm));
+		header.parameters[0] = epsilon, header.parameters[1] = lambda;
+		header.offset = scheduler.offset();
+		header.updates = scheduler.updates();
+		header.logHash = scheduler.prefixHash(header.offset);
+		header.lastTimestamp = scheduler.lastInsertionTimestamp();
+		header.schedulerFlags = scheduler.idFlags();
+		CheckpointWriter out(fileName, header);
+		out.put(scheduler.originalIds(h.nNodes));
+		h.save(out);
+		out.put(tau);
+		out.put(Lambda);
+		out.put(succ);
+		out.put(pred);
+		out.put(position);
+		out.put(b);
+		out.put(sigma);
+		out.put(hist);
+		return out.close();
+	}
+	bool loadCheckpoint(const char *fileName) {
+		CheckpointReader in(fileName);
+		const double parameters[3] = {epsilon, lambda, 0};
+		if (!in.ok() || strncmp(in.header.algorithm, "Incremental", sizeof(in.header.algorithm)) != 0
+			|| memcmp(in.header.parameters, parameters, sizeof(parameters)) != 0)
+			return false;
+		if (in.header.logHash != 0 && !scheduler.live() && in.header.logHash != scheduler.prefixHash(in.header.offset)) {
+			cerr << "The checkpoint " << fileName << " was taken on another log" << endl;
+			return false;
+		}
+		if (in.header.schedulerFlags != scheduler.idFlags()) {
+			cerr << "The checkpoint " << fileName << " was taken " << (in.header.schedulerFlags & COLLAPSE_PARALLEL ? "with" : "without")
+				<< " collapse; pass the same options to restore it" << endl;
+			exit(1);
+		}
+		vector<Node> originalIds;
+		in.get(originalIds);
+		h.load(in);
+		in.get(tau);
+		in.get(Lambda);
+		in.get(succ);
+		in.get(pred);
+		in.get(position);
+		in.get(b);
+		in.get(sigma);
+		in.get(hist);
+		if (!in.ok()) {
+			cerr << "The checkpoint " << fileName << " is truncated" << endl;
+			exit(1);
+		}
+		scheduler.start(in.header.offset, in.header.updates, in.header.lastTimestamp, &originalIds, &h);
+		for (Node u = 0; u < b[tau].size(); ++u)
+			topChanged.insert(u);
+		publish();
+		cerr << "Restored " << in.header.updates << " updates from " << fileName << ", tau = " << tau << endl;
+		return true;
+	}
+	unsigned getApproxCoreVal(Node u) {
+		// u is a node ID of the input. Only for the thread that runs run(); other threads use readApproxCoreVal().
+		Node v;
+		if (!scheduler.denseId(u, v) || v >= b[tau].size())
+			return 0;
+		return b[tau][v];
+	}
+	// See FullyDynamic::readApproxCoreVal() and readApproxCoreVals()
+	unsigned readApproxCoreVal(Node u) {
+		Node v;
+		return scheduler.denseId(u, v) ? snapshot.get(v) : 0;
+	}
+	unsigned long long readApproxCoreVals(const vector<Node>& nodes, vector<unsigned>& values) {
+		vector<Node> dense(nodes.size());
+		vector<bool> known(nodes.size());
+		for (size_t i = 0; i < nodes.size(); ++i)
+			known[i] = scheduler.denseId(nodes[i], dense[i]);
+		values.resize(nodes.size());
+		const unsigned long long epoch = snapshot.get(dense.data(), dense.data() + dense.size(), values.data());
+		for (size_t i = 0; i < nodes.size(); ++i)
+			if (!known[i])
+				values[i] = 0;
+		return epoch;
+	}
+	Hypergraph h;
+private:
+	double epsilon, lambda;
+	GraphScheduler scheduler;
+
+	int tau;
+	vector<unsigned> Lambda, succ, pred;
+	vector<vector<unsigned>> b, sigma; // Indexed by level and then by (dense) node ID
+	vector<unsigned> position; // position[x] is the index of x in Lambda, for every value x of the ladder
+	// Nodes with at least HISTOGRAM_DEGREE incident edges get a histogram: hist[u][t * (Lambda.size() + 1) + position[x]] is the number of edges of u
+	// (counting parallel copies) whose b_e at level t - 1 is x, and the infinite b_e of level 1 is in the last bucket.
+	// sigma then follows a promotion in O(1) time instead of a scan of all edges of u.
+	static const size_t HISTOGRAM_DEGREE = 128;
+	vector<vector<unsigned>> hist;
+	Worklist bad, bad2; // Nodes to check at the current level and at the next one
+	CoreSnapshot snapshot; // b[tau][u] for the readers on other threads, published after every insertion
+	Worklist topChanged; // Nodes whose b[tau] has changed since the last publication
+	void initialize() {
+		// tau and the ladder grow with the number of nodes and the degrees (see addLevels() and growLadder()),
+		// so the statistics of the scheduler are only a head start and may be 0
+		tau = levelsFor(scheduler.numberOfNodes);
+		Lambda.assign(1, 0);
+		position.assign(1, 0);
+		growLadder(0);
+		b.resize(tau + 1, vector<unsigned>(scheduler.numberOfNodes));
+		hist.resize(scheduler.numberOfNodes);
+		sigma.resize(tau + 1, vector<unsigned>(scheduler.numberOfNodes));
+		cerr << "Lambda: ";
+		for (auto& lambda: Lambda) cerr << lambda << ' ';
+		cerr << endl;
+		cerr << "# of nodes = " << scheduler.numberOfNodes << endl;
+		cerr << "tau = " << tau << endl;
+		cerr << "max degree = " << scheduler.maxDegree << endl;
+	}
+	void insertEdge(const Hyperedge& e, unsigned eId) {
+	//	cerr << "Insert an edge" << endl;
+		Node last = 0;
+		for (const Node u: e)
+			last = max(last, u);
+		if (last >= b[0].size()) {
+			addLevels(last + 1);
+			addNode(last);
+		}
+		addHistograms(e);
+		h.insertEdge(e, eId);
+		for (const Node u: e)
+			growLadder(h.degree[u]);
+		bad.clear();
+		for (const Node u: e) {
+			++sigma[1][u], bad.insert(u);
+			if (!hist[u].empty())
+				++hist[u][bucket(1, INT_MAX)];
+		}
+		for (unsigned t = 1; t <= tau; ++t) {
+			bad2.clear();
+			if (t < tau) {
+				unsigned b_e = INT_MAX;
+				for (const Node u: e)
+					b_e = min(b_e, b[t][u]);
+				for (const Node u: e) {
+					if (b_e >= succ[b[t + 1][u]])
+						++sigma[t + 1][u], bad2.insert(u);
+					if (!hist[u].empty())
+						++hist[u][bucket(t + 1, b_e)];
+				}
+			}
+			for (const Node u: bad)
+				if (sigma[t][u] >= succ[b[t][u]])
+					promote(t, u, bad2);
+			swap(bad, bad2);
+		}
+		publish();
+	}
+	void publish() {
+		if (topChanged.empty()) return;
+		snapshot.beginWrite();
+		for (const Node u: topChanged)
+			snapshot.set(u, b[tau][u]);
+		snapshot.endWrite();
+		topChanged.clear();
+	}
+	void promote(const unsigned t, const Node u, Worklist& bad2) {
+	//	cerr << "Promote " << t << ' ' << u << ' ' << newEdgeId << endl;
+		unsigned old_b_t_u = b[t][u];
+		b[t][u] = succ[b[t][u]];
+		updateSigma(t, u);
+	//	cerr << "b[" << t << "][" << u << "] = " << b[t][u] << ", sigma[" << t << "][" << u << "] = " << sigma[t][u] << endl;
+		if (t == tau) {
+			topChanged.insert(u);
+			return;
+		}
+		for (const unsigned eId: h.eList[u]) {
+	//		cerr << "eId = " << eId << endl;
+			const EdgeRange e = h.edge(eId);
+			const unsigned m = h.edgeMultiplicity[eId];
+			unsigned old_b_e = INT_MAX;
+			for (const Node v: e)
+				if (v != u)
+					old_b_e = min(old_b_e, b[t][v]);
+			unsigned new_b_e = min(old_b_e, b[t][u]);
+			old_b_e = min(old_b_e, old_b_t_u);
+			if (new_b_e == old_b_e) continue;
+			for (const Node v: e) {
+				if (old_b_e < succ[b[t + 1][v]]
+							&& succ[b[t + 1][v]] <= new_b_e)
+					sigma[t + 1][v] += m, bad2.insert(v);
+				if (!hist[v].empty())
+					hist[v][bucket(t + 1, old_b_e)] -= m, hist[v][bucket(t + 1, new_b_e)] += m;
+			}
+		}
+	//	cerr << "Promote finished." << endl;
+	}
+	void addNode(Node u) {
+		// Nodes the scheduler did not count (all of them without a prescan) are added on their first insertion
+		for (int t = 0; t <= tau; ++t) {
+			b[t].resize(u + 1);
+			sigma[t].resize(u + 1);
+		}
+		hist.resize(u + 1);
+	}
+	int levelsFor(unsigned n) const {
+		// tau for a hypergraph of n nodes
+		return max(1, (int)ceil(0.15 * log((double)max(n, 1u)) / log(1.0 + epsilon)));
+	}
+	void addLevels(unsigned n) {
+		// Levels only depend on the ones below, so the new top levels are computed from the current state, one after another,
+		// by promoting every node from 0 for as long as it may be promoted. No update has to be replayed.
+		const int oldTau = tau, newTau = levelsFor(n);
+		if (newTau <= oldTau) return;
+		const size_t nodes = b[0].size();
+		b.resize(newTau + 1, vector<unsigned>(nodes));
+		sigma.resize(newTau + 1, vector<unsigned>(nodes));
+		for (auto& buckets: hist)
+			if (!buckets.empty())
+				buckets.resize((newTau + 1) * (Lambda.size() + 1));
+		tau = newTau;
+		for (int t = oldTau + 1; t <= tau; ++t) {
+			for (Node u = 0; u < hist.size(); ++u)
+				if (!hist[u].empty())
+					for (const unsigned eId: h.eList[u]) {
+						unsigned b_e = INT_MAX;
+						for (const Node v: h.edge(eId))
+							b_e = min(b_e, b[t - 1][v]);
+						hist[u][bucket(t, b_e)] += h.edgeMultiplicity[eId];
+					}
+			for (Node u = 0; u < nodes; ++u) {
+				countSigma(t, u);
+				while (sigma[t][u] >= succ[b[t][u]]) {
+					b[t][u] = succ[b[t][u]];
+					updateSigma(t, u);
+				}
+			}
+		}
+		for (Node u = 0; u < nodes; ++u)
+			topChanged.insert(u);
+		cerr << "tau = " << tau << endl;
+	}
+	void growLadder(unsigned degree) {
+		// Keep the last value of the ladder above every degree, so that a node can never be promoted past it.
+		// This builds the same ladder as knowing the maximum degree in advance would.
+		if (Lambda.back() > degree) return;
+		const size_t oldH = Lambda.size() + 1;
+		while (Lambda.back() <= degree)
+			Lambda.push_back(max((unsigned)(Lambda.back() * (1.0 + lambda)), Lambda.back() + 1));
+		succ.resize(Lambda.back() + 1);
+		pred.resize(Lambda.back() + 1);
+		position.resize(Lambda.back() + 1);
+		for (size_t j = 0; j + 1 < Lambda.size(); ++j)
+			succ[Lambda[j]] = Lambda[j + 1], pred[Lambda[j + 1]] = Lambda[j];
+		for (size_t j = 0; j < Lambda.size(); ++j)
+			position[Lambda[j]] = j;
+		// Histograms are laid out by the length of the ladder, with the bucket of the infinite b_e last
+		const size_t H = Lambda.size() + 1;
+		for (auto& buckets: hist) {
+			if (buckets.empty()) continue;
+			vector<unsigned> grown((tau + 1) * H);
+			for (int t = 0; t <= tau; ++t) {
+				copy(buckets.begin() + t * oldH, buckets.begin() + (t + 1) * oldH - 1, grown.begin() + t * H);
+				grown[t * H + H - 1] = buckets[t * oldH + oldH - 1];
+			}
+			buckets.swap(grown);
+		}
+	}
+	inline size_t bucket(unsigned t, unsigned b_e) const {
+		return t * (Lambda.size() + 1) + (b_e == INT_MAX ? Lambda.size() : position[b_e]);
+	}
+	void addHistograms(const Hyperedge& e) {
+		// Called before edge e is inserted, so that its endpoints count it in their histograms once it reaches each level
+		for (const Node u: e) {
+			if (u >= hist.size() || !hist[u].empty() || u >= h.eList.size() || h.eList[u].size() < HISTOGRAM_DEGREE) continue;
+			hist[u].assign((tau + 1) * (Lambda.size() + 1), 0);
+			for (const unsigned eId: h.eList[u]) {
+				const EdgeRange e = h.edge(eId);
+				const unsigned m = h.edgeMultiplicity[eId];
+				hist[u][bucket(1, INT_MAX)] += m;
+				for (int t = 2; t <= tau; ++t) {
+					unsigned b_e = INT_MAX;
+					for (const Node v: e)
+						b_e = min(b_e, b[t - 1][v]);
+					hist[u][bucket(t, b_e)] += m;
+				}
+			}
+		}
+	}
+	void updateSigma(unsigned t, Node u) {
+		if (!hist[u].empty()) {
+			// After a promotion, the edges with b_e at least the old succ[b] are those with b_e at least the new b
+			sigma[t][u] -= hist[u][bucket(t, b[t][u])];
+			return;
+		}
+		countSigma(t, u);
+	}
+	void countSigma(unsigned t, Node u) {
+		sigma[t][u] = 0;
+		for (const unsigned eId: h.eList[u]) {
+			const EdgeRange e = h.edge(eId);
+			const unsigned m = h.edgeMultiplicity[eId];
+			unsigned b_e = INT_MAX;
+			if (t > 1)
+				for (const Node v: e)
+					b_e = min(b_e, b[t - 1][v]);
+			if (b_e >= succ[b[t][u]]) sigma[t][u] += m;
+		}
+	}
+};
+
+int main(int argc, char **argv) {
+	double epsilon = atof(argv[1]);
+	double lambda = atof(argv[2]);
+	char *fileName = argv[3];
+	Incremental incremental(epsilon, lambda, fileName, GraphScheduler::parseFlags(argc, argv, 4), GraphScheduler::option(argc, argv, 4, "restore"));
+	const char *reportEvery = GraphScheduler::option(argc, argv, 4, "report"), *reportInterval = GraphScheduler::option(argc, argv, 4, "interval");
+	time_t t = clock();
+	incremental.run(reportEvery == NULL ? 100000 : atoi(reportEvery), reportInterval == NULL ? 0 : atof(reportInterval),
+		GraphScheduler::option(argc, argv, 4, "values"), GraphScheduler::option(argc, argv, 4, "checkpoint"));
+	cerr << (clock() - t) << " ms." << endl;
+//	Node u;
+//	while (cin >> u)
+//		cout << incremental.getApproxCoreVal(u) << endl;
+	return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef __MAPPEDFILE__
+#define __MAPPEDFILE__
+
+#include <cstddef>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// A read-only memory mapping of a whole file.
+// data() is NULL if the file cannot be opened or mapped, or is empty; ok() tells these apart.
+class MappedFile {
+public:
+	MappedFile(const char fileName[]): ptr(NULL), len(0), good(false) {
+#ifdef _WIN32
+		mapping = NULL;
+		file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE) return;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) return;
+		good = size.QuadPart == 0;
+		if (good) return;
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL) return;
+		ptr = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (ptr != NULL) len = size.QuadPart;
+		good = ptr != NULL;
+#else
+		fd = open(fileName, O_RDONLY);
+		if (fd < 0) return;
+		struct stat st;
+		if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) return;
+		good = st.st_size == 0;
+		if (good) return;
+		void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) return;
+		madvise(p, st.st_size, MADV_SEQUENTIAL);
+		ptr = (const char *)p;
+		len = st.st_size;
+		good = true;
+#endif
+	}
+	~MappedFile() {
+#ifdef _WIN32
+		if (ptr != NULL) UnmapViewOfFile(ptr);
+		if (mapping != NULL) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+		if (ptr != NULL) munmap((void *)ptr, len);
+		if (fd >= 0) close(fd);
+#endif
+	}
+	const char *data() const {
+		return ptr;
+	}
+	size_t size() const {
+		return len;
+	}
+	// False if the file could not be opened or mapped; an empty file is ok() with data() NULL
+	bool ok() const {
+		return good;
+	}
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+	const char *ptr;
+	size_t len;
+	bool good;
+#ifdef _WIN32
+	HANDLE file, mapping;
+#else
+	int fd;
+#endif
+};
+#endif
@@ -0,0 +1,102 @@
+#ifndef __RINGBUFFER__
+#define __RINGBUFFER__
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+
+// A bounded single-producer single-consumer ring buffer.
+// Slots are reused in place, so elements that own memory (e.g. vectors) keep their capacity
+// and the steady state does not allocate.
+// Either side spins briefly and then sleeps on a condition variable when the buffer is full/empty.
+template<class T>
+class RingBuffer {
+public:
+	RingBuffer(size_t capacity): slots(capacity), head(0), tail(0), closed(false), producerWaiting(false), consumerWaiting(false) {}
+	// Producer: a slot to fill, or NULL if the buffer has been closed
+	T *acquireWrite() {
+		for (int spin = 0; head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire) == slots.size(); ++spin) {
+			if (closed.load(std::memory_order_acquire)) return NULL;
+			if (spin < SPIN) {
+				std::this_thread::yield();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(m);
+			producerWaiting.store(true, std::memory_order_seq_cst);
+			cv.wait(lock, [this] {
+				return closed.load() || head.load() - tail.load() < slots.size();
+			});
+			producerWaiting.store(false, std::memory_order_relaxed);
+		}
+		if (closed.load(std::memory_order_acquire)) return NULL;
+		return &slots[head.load(std::memory_order_relaxed) % slots.size()];
+	}
+	void commitWrite() {
+		head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		wake(consumerWaiting);
+	}
+	// Consumer: the oldest element, or NULL if the buffer is empty and closed
+	T *acquireRead() {
+		for (int spin = 0; tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire); ++spin) {
+			if (closed.load(std::memory_order_acquire) && tail.load() == head.load()) return NULL;
+			if (spin < SPIN) {
+				std::this_thread::yield();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(m);
+			consumerWaiting.store(true, std::memory_order_seq_cst);
+			cv.wait(lock, [this] {
+				return closed.load() || tail.load() != head.load();
+			});
+			consumerWaiting.store(false, std::memory_order_relaxed);
+		}
+		return &slots[tail.load(std::memory_order_relaxed) % slots.size()];
+	}
+	// Consumer: wait until an element is available or the buffer is closed (then return true), or until deadline (then return false)
+	bool waitRead(std::chrono::steady_clock::time_point deadline) {
+		if (tail.load(std::memory_order_relaxed) != head.load(std::memory_order_acquire) || closed.load(std::memory_order_acquire))
+			return true;
+		std::unique_lock<std::mutex> lock(m);
+		consumerWaiting.store(true, std::memory_order_seq_cst);
+		bool ready = cv.wait_until(lock, deadline, [this] {
+			return closed.load() || tail.load() != head.load();
+		});
+		consumerWaiting.store(false, std::memory_order_relaxed);
+		return ready;
+	}
+	// Consumer: the number of elements in the buffer, including one acquired but not committed yet
+	size_t size() const {
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+	}
+	void commitRead() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		wake(producerWaiting);
+	}
+	// Called by the producer at the end of input, or by the consumer to abandon the producer
+	void close() {
+		std::lock_guard<std::mutex> lock(m);
+		closed.store(true);
+		cv.notify_all();
+	}
+private:
+	static const int SPIN = 64;
+	std::vector<T> slots;
+	std::atomic<size_t> head, tail;
+	std::atomic<bool> closed;
+	// Each side sets only its own flag, so one side leaving the wait cannot clear the flag of the other
+	std::atomic<bool> producerWaiting, consumerWaiting;
+	std::mutex m;
+	std::condition_variable cv;
+	// Notify the other side if it is asleep (or about to be)
+	void wake(const std::atomic<bool>& otherWaiting) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (otherWaiting.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> lock(m);
+			cv.notify_all();
+		}
+	}
+};
+#endif
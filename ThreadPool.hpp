@@ -0,0 +1,111 @@
+#ifndef __THREADPOOL__
+#define __THREADPOOL__
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+// A fixed set of worker threads that execute one parallel loop at a time.
+// The calling thread takes part in the loop, so a pool of size() == 1 has no extra threads.
+class ThreadPool {
+public:
+	ThreadPool(unsigned nThreads = 0): generation(0), stopping(false), busy(false) {
+		if (nThreads == 0)
+			nThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned i = 1; i < nThreads; ++i)
+			workers.push_back(std::thread(&ThreadPool::work, this, i));
+	}
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m);
+			stopping = true;
+		}
+		start.notify_all();
+		for (auto& worker: workers)
+			worker.join();
+	}
+	unsigned size() const {
+		return workers.size() + 1;
+	}
+	// Call f(i, w) for every i in [0, n), where w < size() identifies the executing thread.
+	// Indices are claimed dynamically in blocks of grain, so uneven work is balanced.
+	// A loop started from inside another loop of the same pool runs on the calling thread.
+	// Apart from such nesting, only one thread at a time may start loops on a pool.
+	void parallelFor(size_t n, const std::function<void(size_t, unsigned)>& f, size_t grain = 1) {
+		if (n == 0) return;
+		bool expected = false;
+		if (workers.empty() || n <= grain || !busy.compare_exchange_strong(expected, true)) {
+			unsigned w = currentPool() == this ? currentWorker() : 0;
+			for (size_t i = 0; i < n; ++i)
+				f(i, w);
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m);
+			job = &f;
+			jobSize = n;
+			jobGrain = grain;
+			next.store(0);
+			pending = workers.size();
+			++generation;
+		}
+		start.notify_all();
+		run(0);
+		{
+			std::unique_lock<std::mutex> lock(m);
+			finish.wait(lock, [this] { return pending == 0; });
+			job = NULL;
+		}
+		busy.store(false);
+	}
+private:
+	std::vector<std::thread> workers;
+	std::mutex m;
+	std::condition_variable start, finish;
+	const std::function<void(size_t, unsigned)> *job;
+	size_t jobSize, jobGrain;
+	std::atomic<size_t> next;
+	unsigned pending;
+	unsigned long long generation;
+	bool stopping;
+	std::atomic<bool> busy;
+	static const ThreadPool *& currentPool() {
+		static thread_local const ThreadPool *pool = NULL;
+		return pool;
+	}
+	static unsigned& currentWorker() {
+		static thread_local unsigned w = 0;
+		return w;
+	}
+	void run(unsigned w) {
+		for (size_t i; (i = next.fetch_add(jobGrain)) < jobSize;) {
+			size_t end = std::min(jobSize, i + jobGrain);
+			for (; i < end; ++i)
+				(*job)(i, w);
+		}
+	}
+	void work(unsigned w) {
+		currentPool() = this;
+		currentWorker() = w;
+		unsigned long long seen = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(m);
+				start.wait(lock, [this, seen] { return stopping || generation != seen; });
+				if (stopping) return;
+				seen = generation;
+			}
+			run(w);
+			{
+				std::lock_guard<std::mutex> lock(m);
+				if (--pending == 0)
+					finish.notify_one();
+			}
+		}
+	}
+};
+#endif
@@ -0,0 +1,68 @@
+#ifndef __UPDATESTATS__
+#define __UPDATESTATS__
+
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include "GraphScheduler.hpp"
+
+// Throughput and latency of the updates an algorithm processes, reported every `every` updates
+// and, with interval > 0, also once interval seconds have passed since the last report.
+// Latency is measured from the arrival of an update on a live input (see EdgeUpdate::arrival) until it has been applied.
+class UpdateStats {
+public:
+	typedef std::chrono::steady_clock Clock;
+	UpdateStats(size_t every = 100000, double interval = 0): every(every), interval(interval), lastCount(0) {
+		start();
+	}
+	// Whether a report is due after cnt updates
+	bool due(size_t cnt) const {
+		return (every > 0 && cnt % every == 0 && cnt != lastCount) || (interval > 0 && Clock::now() >= deadline());
+	}
+	// When the next report is due by time (with interval > 0)
+	Clock::time_point deadline() const {
+		return last + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+	}
+	void applied(const EdgeUpdate& update) {
+		if (update.arrival == Clock::time_point()) return;
+		const double latency = seconds(Clock::now() - update.arrival);
+		totalLatency += latency;
+		maxLatency = std::max(maxLatency, latency);
+		++measured;
+	}
+	void report(size_t cnt) {
+		const double elapsed = seconds(Clock::now() - last);
+		std::cerr << cnt << " updates, " << (size_t)((cnt - lastCount) / std::max(elapsed, 1e-9)) << " updates/s";
+		if (measured > 0)
+			std::cerr << ", latency " << totalLatency / measured * 1000 << " ms on average and " << maxLatency * 1000 << " ms at most";
+		std::cerr << std::endl;
+		lastCount = cnt;
+		start();
+	}
+	// Move the snapshot written to fileName + ".tmp" over fileName, so that readers see either the old or the new one
+	static void publish(const std::string& fileName) {
+		const std::string tmp = fileName + ".tmp";
+		if (rename(tmp.c_str(), fileName.c_str()) != 0) {
+			// Windows does not replace an existing file
+			remove(fileName.c_str());
+			rename(tmp.c_str(), fileName.c_str());
+		}
+	}
+private:
+	size_t every;
+	double interval;
+	size_t lastCount, measured;
+	double totalLatency, maxLatency;
+	Clock::time_point last;
+	static double seconds(Clock::duration d) {
+		return std::chrono::duration<double>(d).count();
+	}
+	void start() {
+		last = Clock::now();
+		measured = 0;
+		totalLatency = maxLatency = 0;
+	}
+};
+#endif
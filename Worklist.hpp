@@ -0,0 +1,62 @@
+#ifndef __WORKLIST__
+#define __WORKLIST__
+
+#include <vector>
+#include <algorithm>
+#include "Hypergraph.hpp"
+
+// A set of nodes (or of edge IDs) meant to be kept by an engine and reused for every update.
+// Membership is an epoch stamp per node, so clear() takes O(1) time and nothing is allocated
+// once the arrays have grown to the number of nodes and the largest cascade.
+class Worklist {
+public:
+	Worklist(): epoch(1) {}
+	// Returns false if u is already in the list
+	bool insert(Node u) {
+		if (u >= stamp.size())
+			stamp.resize(u + 1, 0);
+		if (stamp[u] == epoch)
+			return false;
+		stamp[u] = epoch;
+		items.push_back(u);
+		return true;
+	}
+	bool contains(Node u) const {
+		return u < stamp.size() && stamp[u] == epoch;
+	}
+	// Remove and return the node inserted last
+	Node pop() {
+		Node u = items.back();
+		items.pop_back();
+		stamp[u] = 0;
+		return u;
+	}
+	void clear() {
+		items.clear();
+		if (++epoch == 0) {
+			std::fill(stamp.begin(), stamp.end(), 0);
+			epoch = 1;
+		}
+	}
+	bool empty() const {
+		return items.empty();
+	}
+	size_t size() const {
+		return items.size();
+	}
+	// Iteration visits the nodes in order of insertion; inserting while iterating is not allowed
+	Node operator[](size_t i) const {
+		return items[i];
+	}
+	std::vector<Node>::const_iterator begin() const {
+		return items.begin();
+	}
+	std::vector<Node>::const_iterator end() const {
+		return items.end();
+	}
+private:
+	std::vector<Node> items;
+	std::vector<unsigned> stamp; // stamp[u] == epoch iff u is in the list
+	unsigned epoch;
+};
+#endif